@@ -35,7 +35,7 @@ void ImGui_ImplNLSWin_NewFrame() {
    data->lastFrameEnd = std::chrono::steady_clock::now();
 }
 
-void ImGui_ImplNLSWin_HandleEvent(NLSWIN::Event ev) {
+void ImGui_ImplNLSWin_HandleEvent(const NLSWIN::Event &ev) {
    ImGuiIO &io = ImGui::GetIO();
    ImGui_ImplNLSWin_Data *data = (ImGui_ImplNLSWin_Data *)(io.BackendPlatformUserData);
    IM_ASSERT(data != nullptr);
@@ -63,6 +63,14 @@ void ImGui_ImplNLSWin_HandleEvent(NLSWIN::Event ev) {
    }
 }
 
+void ImGui_ImplNLSWin_HandleEvents(NLSWIN::EventListener &listener) {
+   NLSWIN::Event events[64];
+   size_t count = 0;
+   while ((count = listener.DrainEvents(events, 64)) > 0) {
+      for (size_t i = 0; i < count; i++) { ImGui_ImplNLSWin_HandleEvent(events[i]); }
+   }
+}
+
 void ImGui_ImplNLSWin_Shutdown() {
    ImGuiIO &io = ImGui::GetIO();
    ImGui_ImplNLSWin_Data *data = (ImGui_ImplNLSWin_Data *)(io.BackendPlatformUserData);
@@ -6,7 +6,8 @@
 
 IMGUI_IMPL_API bool ImGui_ImplNLSWin_Init(std::weak_ptr<NLSWIN::Window> window);
 IMGUI_IMPL_API void ImGui_ImplNLSWin_NewFrame();
-IMGUI_IMPL_API void ImGui_ImplNLSWin_HandleEvent(NLSWIN::Event ev);
+IMGUI_IMPL_API void ImGui_ImplNLSWin_HandleEvent(const NLSWIN::Event &ev);
+IMGUI_IMPL_API void ImGui_ImplNLSWin_HandleEvents(NLSWIN::EventListener &listener);
 IMGUI_IMPL_API void ImGui_ImplNLSWin_Shutdown();
 
 constexpr std::chrono::steady_clock::time_point nullLastFrame = std::chrono::steady_clock::time_point::min();
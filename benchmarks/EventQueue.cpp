@@ -0,0 +1,132 @@
+/*
+ * Compares the RingBuffer backing X11EventListener queues against the std::queue it replaced.
+ *
+ * Single threaded: a listener receives a burst of events during PollEvents, and the application drains all
+ * of them once per frame.
+ * Two threads: an input thread pushes events while the application thread pops them. std::queue needs a
+ * mutex to do this at all.
+ */
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "Common/RingBuffer.hpp"
+#include "NamelessWindow/Events/Event.hpp"
+
+using namespace NLSWIN;
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t FRAMES = 20000;
+constexpr size_t EVENTS_PER_FRAME = 1000;
+constexpr size_t THREADED_EVENTS = 5000000;
+
+static Event MakeEvent(size_t i) {
+   RawMouseDeltaMovementEvent event;
+   event.deltaX = static_cast<float>(i);
+   event.deltaY = 1.0f;
+   return event;
+}
+
+static void Report(const char *name, Clock::duration elapsed, size_t events) {
+   double nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count();
+   std::printf("%-36s %8.2f ns/event %10.2f Mevents/s\n", name, nanoseconds / events,
+               events * 1e3 / nanoseconds);
+}
+
+template <typename PushFunc, typename PopFunc>
+static Clock::duration RunBursts(PushFunc push, PopFunc pop) {
+   float sink = 0.0f;
+   auto start = Clock::now();
+   for (size_t frame = 0; frame < FRAMES; frame++) {
+      for (size_t i = 0; i < EVENTS_PER_FRAME; i++) { push(MakeEvent(i)); }
+      Event event;
+      while (pop(event)) { sink += std::get<RawMouseDeltaMovementEvent>(event).deltaX; }
+   }
+   auto elapsed = Clock::now() - start;
+   // Keep the drained values observable so the loop cannot be optimized away.
+   if (sink < 0.0f) {
+      std::printf("%f\n", sink);
+   }
+   return elapsed;
+}
+
+static void BenchmarkBursts() {
+   std::queue<Event> stdQueue;
+   auto elapsed = RunBursts([&](Event &&event) { stdQueue.push(std::move(event)); },
+                            [&](Event &out) {
+                               if (stdQueue.empty()) {
+                                  return false;
+                               }
+                               out = std::move(stdQueue.front());
+                               stdQueue.pop();
+                               return true;
+                            });
+   Report("burst std::queue", elapsed, FRAMES * EVENTS_PER_FRAME);
+
+   RingBuffer<Event> ringBuffer(EVENTS_PER_FRAME);
+   elapsed = RunBursts([&](Event &&event) { ringBuffer.Push(std::move(event)); },
+                       [&](Event &out) { return ringBuffer.TryPop(out); });
+   Report("burst RingBuffer", elapsed, FRAMES * EVENTS_PER_FRAME);
+
+   RingBuffer<Event> growingBuffer(16);
+   elapsed = RunBursts([&](Event &&event) { growingBuffer.Push(std::move(event)); },
+                       [&](Event &out) { return growingBuffer.TryPop(out); });
+   Report("burst RingBuffer (grown from 16)", elapsed, FRAMES * EVENTS_PER_FRAME);
+}
+
+template <typename PushFunc, typename PopFunc>
+static Clock::duration RunThreaded(PushFunc push, PopFunc pop) {
+   auto start = Clock::now();
+   std::thread producer([&]() {
+      for (size_t i = 0; i < THREADED_EVENTS; i++) {
+         Event event = MakeEvent(i);
+         while (!push(event)) { std::this_thread::yield(); }
+      }
+   });
+   size_t received = 0;
+   Event event;
+   while (received < THREADED_EVENTS) {
+      if (pop(event)) {
+         received++;
+      } else {
+         std::this_thread::yield();
+      }
+   }
+   producer.join();
+   return Clock::now() - start;
+}
+
+static void BenchmarkThreaded() {
+   std::queue<Event> stdQueue;
+   std::mutex mutex;
+   auto elapsed = RunThreaded(
+      [&](Event &event) {
+         std::lock_guard<std::mutex> lock(mutex);
+         stdQueue.push(std::move(event));
+         return true;
+      },
+      [&](Event &out) {
+         std::lock_guard<std::mutex> lock(mutex);
+         if (stdQueue.empty()) {
+            return false;
+         }
+         out = std::move(stdQueue.front());
+         stdQueue.pop();
+         return true;
+      });
+   Report("threaded std::queue + mutex", elapsed, THREADED_EVENTS);
+
+   RingBuffer<Event> ringBuffer(EVENTS_PER_FRAME, QueueOverflowPolicy::DROP_NEWEST);
+   elapsed = RunThreaded([&](Event &event) { return ringBuffer.TryPush(event); },
+                         [&](Event &out) { return ringBuffer.TryPop(out); });
+   Report("threaded RingBuffer", elapsed, THREADED_EVENTS);
+}
+
+int main() {
+   std::printf("sizeof(Event) = %zu\n", sizeof(Event));
+   BenchmarkBursts();
+   BenchmarkThreaded();
+   return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * A headless Xvfb server for the X11 benchmarks to run against.
+ */
+#pragma once
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+
+/* Owns an Xvfb server on a display number it picks itself, for the lifetime of the benchmark. */
+class XvfbServer {
+   public:
+   /* Starts the server, and points $DISPLAY at it once it is ready. @returns False if it could not start. */
+   bool Start() {
+      int displayPipe[2];
+      if (pipe(displayPipe) != 0) {
+         return false;
+      }
+      m_pid = fork();
+      if (m_pid < 0) {
+         return false;
+      }
+      if (m_pid == 0) {
+         close(displayPipe[0]);
+         std::string fd = std::to_string(displayPipe[1]);
+         execlp("Xvfb", "Xvfb", "-displayfd", fd.c_str(), "-screen", "0", "1280x1024x24", "-nolisten", "tcp",
+                static_cast<char *>(nullptr));
+         _exit(127);
+      }
+      close(displayPipe[1]);
+      // Xvfb writes the display number it settled on once it is ready to accept connections.
+      std::string display;
+      char c;
+      while (read(displayPipe[0], &c, 1) == 1 && c != '\n') { display.push_back(c); }
+      close(displayPipe[0]);
+      if (display.empty()) {
+         return false;
+      }
+      setenv("DISPLAY", (":" + display).c_str(), 1);
+      return true;
+   }
+   ~XvfbServer() {
+      if (m_pid > 0) {
+         kill(m_pid, SIGTERM);
+         waitpid(m_pid, nullptr, 0);
+      }
+   }
+
+   private:
+   pid_t m_pid {-1};
+};
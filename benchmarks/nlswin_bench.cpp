@@ -0,0 +1,447 @@
+/*
+ * End-to-end input benchmark, driven by synthetic XTest input on a headless Xvfb server.
+ *
+ * Windows, a keyboard and the cursor are created through the public API, exactly as an application would.
+ * A second connection then injects key, button and motion events at controlled rates, and measures:
+ *  - events/s:       how many injected events were delivered to the listeners per second.
+ *  - dispatch cost:  time spent inside EventBus::PollEvents per delivered event.
+ *  - latency:        time from injecting an event to it being drained from its listener.
+ *
+ * Three phases are run: a ping-pong phase (one event in flight, so latency is not hidden behind queueing), a
+ * paced phase at --rate events per second per stream, and a saturated phase that keeps as many events in
+ * flight as the server will buffer.
+ *
+ * The process exits with 1 if any threshold is exceeded, if a result regressed by more than --tolerance
+ * against a --baseline file, or if any event was lost, and with 2 if the benchmark could not be set up.
+ */
+#include <fcntl.h>
+#include <unistd.h>
+#include <xcb/xcb.h>
+#include <xcb/xtest.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "NamelessWindow/Cursor.hpp"
+#include "NamelessWindow/Events/EventBus.hpp"
+#include "NamelessWindow/Events/LatencyProfiler.hpp"
+#include "NamelessWindow/Keyboard.hpp"
+#include "NamelessWindow/Window.hpp"
+#include "XvfbServer.hpp"
+
+using namespace NLSWIN;
+using Clock = std::chrono::steady_clock;
+
+constexpr int EXIT_REGRESSION = 1;
+constexpr int EXIT_SETUP_FAILURE = 2;
+
+/* Keycode 38 is the A key in the evdev keymap that Xvfb loads by default. */
+constexpr uint8_t INJECTED_KEYCODE = 38;
+constexpr uint8_t INJECTED_BUTTON = 1;
+constexpr int WINDOW_X = 100;
+constexpr int WINDOW_Y = 100;
+constexpr int WINDOW_WIDTH = 640;
+constexpr int WINDOW_HEIGHT = 480;
+constexpr size_t PING_PONG_ROUNDS = 500;
+/* Kept below what the server buffers for one client, so that no injected event is ever discarded. */
+constexpr size_t SATURATED_IN_FLIGHT = 256;
+constexpr auto DELIVERY_TIMEOUT = std::chrono::seconds(2);
+
+struct Options {
+   bool startXvfb {true};
+   double rate {2000.0};   /* Per stream, in events per second. */
+   double duration {2.0};  /* Of the paced and saturated phases, in seconds. */
+   double tolerance {0.25};
+   double minEventsPerSecond {0.0};
+   double maxDispatchNanoseconds {0.0};
+   double maxP99Microseconds {0.0};
+   std::string baselinePath;
+   std::string writeBaselinePath;
+};
+
+/* Injects core input through XTest, on a connection of its own. */
+class Injector {
+   public:
+   bool Connect() {
+      m_connection = xcb_connect(nullptr, nullptr);
+      if (xcb_connection_has_error(m_connection)) {
+         return false;
+      }
+      const xcb_query_extension_reply_t *xtest = xcb_get_extension_data(m_connection, &xcb_test_id);
+      if (!xtest || !xtest->present) {
+         return false;
+      }
+      m_root = xcb_setup_roots_iterator(xcb_get_setup(m_connection)).data->root;
+      // With no window manager running, focus follows the pointer into the benchmark window.
+      xcb_set_input_focus(m_connection, XCB_INPUT_FOCUS_POINTER_ROOT, XCB_INPUT_FOCUS_POINTER_ROOT,
+                          XCB_CURRENT_TIME);
+      return true;
+   }
+   ~Injector() {
+      if (m_connection) {
+         xcb_disconnect(m_connection);
+      }
+   }
+   void Key(bool press) { Fake(press ? XCB_KEY_PRESS : XCB_KEY_RELEASE, INJECTED_KEYCODE, 0, 0); }
+   void Button(bool press) { Fake(press ? XCB_BUTTON_PRESS : XCB_BUTTON_RELEASE, INJECTED_BUTTON, 0, 0); }
+   void Motion(int16_t x, int16_t y) { Fake(XCB_MOTION_NOTIFY, 0, x, y); }
+   void Flush() { xcb_flush(m_connection); }
+   /* Blocks until the server has processed every injected event. */
+   void Sync() { free(xcb_get_input_focus_reply(m_connection, xcb_get_input_focus(m_connection), nullptr)); }
+
+   private:
+   xcb_connection_t *m_connection {nullptr};
+   xcb_window_t m_root {XCB_NONE};
+
+   void Fake(uint8_t type, uint8_t detail, int16_t x, int16_t y) {
+      xcb_test_fake_input(m_connection, type, detail, XCB_CURRENT_TIME, m_root, x, y, 0);
+   }
+};
+
+/* One kind of injected input, matched in order against the events its listener delivers. */
+struct Stream {
+   const char *name;
+   std::deque<Clock::time_point> inFlight;
+   size_t injected {0};
+   size_t delivered {0};
+   std::vector<double> latencies; /* In microseconds. */
+};
+
+struct PhaseResult {
+   double eventsPerSecond {0.0};
+   double dispatchNanoseconds {0.0};
+   double p50 {0.0};
+   double p99 {0.0};
+   double max {0.0};
+   size_t lost {0};
+};
+
+class Benchmark {
+   public:
+   bool Setup() {
+      if (!m_injector.Connect()) {
+         return false;
+      }
+      WindowProperties properties;
+      properties.xCoordinate = WINDOW_X;
+      properties.yCoordinate = WINDOW_Y;
+      properties.horzResolution = WINDOW_WIDTH;
+      properties.vertResolution = WINDOW_HEIGHT;
+      properties.windowName = "nlswin_bench";
+      m_window = Window::Create(properties);
+      m_window->Show();
+      m_keyboard = Keyboard::Create();
+      m_keyboard->SubscribeToWindow(m_window);
+      m_cursor = Cursor::Create();
+      // Park the pointer inside the window, and discard the enter and focus events that caused.
+      m_injector.Motion(WINDOW_X + WINDOW_WIDTH / 2, WINDOW_Y + WINDOW_HEIGHT / 2);
+      m_injector.Sync();
+      auto settled = Clock::now() + std::chrono::milliseconds(100);
+      while (Clock::now() < settled) {
+         EventBus::PollEvents();
+         Discard();
+      }
+      return true;
+   }
+
+   PhaseResult PingPong() {
+      ResetStreams();
+      for (size_t round = 0; round < PING_PONG_ROUNDS; round++) {
+         for (size_t stream = 0; stream < m_streams.size(); stream++) {
+            Inject(stream);
+            m_injector.Flush();
+            auto deadline = Clock::now() + DELIVERY_TIMEOUT;
+            while (!m_streams[stream].inFlight.empty() && Clock::now() < deadline) { Poll(); }
+         }
+      }
+      return Summarize(m_pollTime);
+   }
+
+   /* Injects at rate events per second per stream, or keeps SATURATED_IN_FLIGHT in flight if rate is 0. */
+   PhaseResult Run(double rate, double duration) {
+      ResetStreams();
+      auto start = Clock::now();
+      auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(duration));
+      size_t scheduled = 0;
+      for (auto now = start; now < end; now = Clock::now()) {
+         size_t due = 0;
+         if (rate > 0.0) {
+            due = static_cast<size_t>(std::chrono::duration<double>(now - start).count() * rate) - scheduled;
+         } else {
+            size_t inFlight = 0;
+            for (const auto &stream: m_streams) { inFlight += stream.inFlight.size(); }
+            due = (SATURATED_IN_FLIGHT - std::min(inFlight, SATURATED_IN_FLIGHT)) / m_streams.size();
+         }
+         for (size_t i = 0; i < due; i++) {
+            for (size_t stream = 0; stream < m_streams.size(); stream++) { Inject(stream); }
+         }
+         scheduled += due;
+         m_injector.Flush();
+         Poll();
+      }
+      auto deadline = Clock::now() + DELIVERY_TIMEOUT;
+      while (InFlight() && Clock::now() < deadline) { Poll(); }
+      PhaseResult result = Summarize(m_pollTime);
+      result.eventsPerSecond = Delivered() / std::chrono::duration<double>(Clock::now() - start).count();
+      return result;
+   }
+
+   private:
+   Injector m_injector;
+   std::shared_ptr<Window> m_window;
+   std::shared_ptr<Keyboard> m_keyboard;
+   std::shared_ptr<Cursor> m_cursor;
+   std::array<Stream, 3> m_streams {Stream {"key"}, Stream {"button"}, Stream {"motion"}};
+   bool m_keyDown {false};
+   bool m_buttonDown {false};
+   bool m_motionToggle {false};
+   Clock::duration m_pollTime {0};
+   std::vector<Event> m_drained = std::vector<Event>(1024);
+
+   void ResetStreams() {
+      for (auto &stream: m_streams) { stream = Stream {stream.name}; }
+      m_pollTime = Clock::duration(0);
+   }
+
+   void Inject(size_t stream) {
+      if (stream == 0) {
+         m_keyDown = !m_keyDown;
+         m_injector.Key(m_keyDown);
+      } else if (stream == 1) {
+         m_buttonDown = !m_buttonDown;
+         m_injector.Button(m_buttonDown);
+      } else {
+         // Alternate between two neighbouring pixels, as moving to the current position generates nothing.
+         m_motionToggle = !m_motionToggle;
+         m_injector.Motion(WINDOW_X + WINDOW_WIDTH / 2 + m_motionToggle, WINDOW_Y + WINDOW_HEIGHT / 2);
+      }
+      m_streams[stream].inFlight.push_back(Clock::now());
+      m_streams[stream].injected++;
+   }
+
+   void Poll() {
+      auto start = Clock::now();
+      EventBus::PollEvents();
+      auto now = Clock::now();
+      m_pollTime += now - start;
+      Drain(*m_keyboard, now);
+      Drain(*m_cursor, now);
+      Drain(*m_window, now);
+   }
+
+   void Drain(EventListener &listener, Clock::time_point now) {
+      size_t count = 0;
+      while ((count = listener.DrainEvents(m_drained.data(), m_drained.size())) > 0) {
+         for (size_t i = 0; i < count; i++) {
+            const Event &event = m_drained[i];
+            if (std::holds_alternative<KeyEvent>(event)) {
+               Deliver(m_streams[0], now);
+            } else if (std::holds_alternative<MouseButtonEvent>(event)) {
+               Deliver(m_streams[1], now);
+            } else if (std::holds_alternative<MouseMovementEvent>(event)) {
+               Deliver(m_streams[2], now);
+            }
+         }
+      }
+   }
+
+   static void Deliver(Stream &stream, Clock::time_point now) {
+      if (stream.inFlight.empty()) {
+         return;
+      }
+      auto latency = std::chrono::duration<double, std::micro>(now - stream.inFlight.front());
+      stream.latencies.push_back(latency.count());
+      stream.inFlight.pop_front();
+      stream.delivered++;
+   }
+
+   void Discard() {
+      for (EventListener *listener: {static_cast<EventListener *>(m_keyboard.get()),
+                                     static_cast<EventListener *>(m_cursor.get()),
+                                     static_cast<EventListener *>(m_window.get())}) {
+         while (listener->DrainEvents(m_drained.data(), m_drained.size()) > 0) {}
+      }
+   }
+
+   bool InFlight() const {
+      return std::any_of(m_streams.begin(), m_streams.end(),
+                         [](const Stream &stream) { return !stream.inFlight.empty(); });
+   }
+
+   size_t Delivered() const {
+      size_t delivered = 0;
+      for (const auto &stream: m_streams) { delivered += stream.delivered; }
+      return delivered;
+   }
+
+   PhaseResult Summarize(Clock::duration pollTime) const {
+      PhaseResult result;
+      std::vector<double> latencies;
+      for (const auto &stream: m_streams) {
+         latencies.insert(latencies.end(), stream.latencies.begin(), stream.latencies.end());
+         result.lost += stream.injected - stream.delivered;
+      }
+      size_t delivered = Delivered();
+      if (delivered > 0) {
+         result.dispatchNanoseconds = std::chrono::duration<double, std::nano>(pollTime).count() / delivered;
+      }
+      if (!latencies.empty()) {
+         std::sort(latencies.begin(), latencies.end());
+         result.p50 = latencies[latencies.size() / 2];
+         result.p99 = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+         result.max = latencies.back();
+      }
+      return result;
+   }
+};
+
+static void Report(const char *phase, const PhaseResult &result) {
+   std::printf("%-10s %12.0f events/s %10.0f ns/event dispatch   latency us p50 %8.1f p99 %8.1f max %8.1f",
+               phase, result.eventsPerSecond, result.dispatchNanoseconds, result.p50, result.p99, result.max);
+   std::printf(result.lost ? "   LOST %zu\n" : "\n", result.lost);
+}
+
+/* A result that gates the run, and the direction in which it regresses. */
+struct Metric {
+   std::string name;
+   double value;
+   bool higherIsBetter;
+   double threshold; /* 0 if there is none. */
+};
+
+static std::map<std::string, double> ReadBaseline(const std::string &path) {
+   std::map<std::string, double> baseline;
+   std::ifstream file(path);
+   std::string name;
+   double value;
+   while (file >> name >> value) { baseline[name] = value; }
+   return baseline;
+}
+
+static bool Check(const std::vector<Metric> &metrics, const Options &options) {
+   bool passed = true;
+   std::map<std::string, double> baseline;
+   if (!options.baselinePath.empty()) {
+      baseline = ReadBaseline(options.baselinePath);
+   }
+   for (const auto &metric: metrics) {
+      if (metric.threshold > 0.0 && (metric.higherIsBetter ? metric.value < metric.threshold
+                                                            : metric.value > metric.threshold)) {
+         std::printf("FAIL %s = %.1f, threshold %.1f\n", metric.name.c_str(), metric.value, metric.threshold);
+         passed = false;
+      }
+      auto previous = baseline.find(metric.name);
+      if (previous == baseline.end()) {
+         continue;
+      }
+      double limit = metric.higherIsBetter ? previous->second * (1.0 - options.tolerance)
+                                           : previous->second * (1.0 + options.tolerance);
+      if (metric.higherIsBetter ? metric.value < limit : metric.value > limit) {
+         std::printf("FAIL %s = %.1f, baseline %.1f\n", metric.name.c_str(), metric.value, previous->second);
+         passed = false;
+      }
+   }
+   if (!options.writeBaselinePath.empty()) {
+      std::ofstream file(options.writeBaselinePath);
+      for (const auto &metric: metrics) { file << metric.name << ' ' << metric.value << '\n'; }
+   }
+   return passed;
+}
+
+static void PrintUsage() {
+   std::printf(
+      "Usage: nlswin_bench [options]\n"
+      "  --no-xvfb                 Use the server in $DISPLAY instead of starting Xvfb\n"
+      "  --rate <events/s>         Injection rate per stream in the paced phase (default 2000)\n"
+      "  --duration <seconds>      Length of the paced and saturated phases (default 2)\n"
+      "  --baseline <file>         Fail if a result is worse than this baseline by more than the tolerance\n"
+      "  --write-baseline <file>   Write this run's results as a baseline\n"
+      "  --tolerance <fraction>    Allowed regression against the baseline (default 0.25)\n"
+      "  --min-events-per-sec <n>  Fail if saturated throughput is lower\n"
+      "  --max-dispatch-ns <n>     Fail if saturated dispatch cost per event is higher\n"
+      "  --max-p99-us <n>          Fail if ping-pong p99 latency is higher\n");
+}
+
+static bool ParseOptions(int argc, char **argv, Options &options) {
+   for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      if (arg == "--no-xvfb") {
+         options.startXvfb = false;
+         continue;
+      }
+      if (i + 1 >= argc) {
+         return false;
+      }
+      std::string value = argv[++i];
+      if (arg == "--rate") {
+         options.rate = std::atof(value.c_str());
+      } else if (arg == "--duration") {
+         options.duration = std::atof(value.c_str());
+      } else if (arg == "--baseline") {
+         options.baselinePath = value;
+      } else if (arg == "--write-baseline") {
+         options.writeBaselinePath = value;
+      } else if (arg == "--tolerance") {
+         options.tolerance = std::atof(value.c_str());
+      } else if (arg == "--min-events-per-sec") {
+         options.minEventsPerSecond = std::atof(value.c_str());
+      } else if (arg == "--max-dispatch-ns") {
+         options.maxDispatchNanoseconds = std::atof(value.c_str());
+      } else if (arg == "--max-p99-us") {
+         options.maxP99Microseconds = std::atof(value.c_str());
+      } else {
+         return false;
+      }
+   }
+   return options.rate > 0.0 && options.duration > 0.0;
+}
+
+int main(int argc, char **argv) {
+   Options options;
+   if (!ParseOptions(argc, argv, options)) {
+      PrintUsage();
+      return EXIT_SETUP_FAILURE;
+   }
+   XvfbServer server;
+   if (options.startXvfb && !server.Start()) {
+      std::fprintf(stderr, "nlswin_bench: could not start Xvfb\n");
+      return EXIT_SETUP_FAILURE;
+   }
+   Benchmark benchmark;
+   if (!benchmark.Setup()) {
+      std::fprintf(stderr, "nlswin_bench: could not connect to the X server, or XTest is missing\n");
+      return EXIT_SETUP_FAILURE;
+   }
+   LatencyProfiler::SetEnabled(true);
+
+   PhaseResult pingPong = benchmark.PingPong();
+   Report("ping-pong", pingPong);
+   PhaseResult paced = benchmark.Run(options.rate, options.duration);
+   Report("paced", paced);
+   PhaseResult saturated = benchmark.Run(0.0, options.duration);
+   Report("saturated", saturated);
+   std::printf("\n%s", LatencyProfiler::GetReport().c_str());
+
+   std::vector<Metric> metrics {
+      {"saturated_events_per_sec", saturated.eventsPerSecond, true, options.minEventsPerSecond},
+      {"saturated_dispatch_ns", saturated.dispatchNanoseconds, false, options.maxDispatchNanoseconds},
+      {"ping_pong_p99_us", pingPong.p99, false, options.maxP99Microseconds},
+      {"paced_p99_us", paced.p99, false, 0.0},
+   };
+   bool passed = Check(metrics, options);
+   size_t lost = pingPong.lost + paced.lost + saturated.lost;
+   if (lost > 0) {
+      std::printf("FAIL %zu injected events were never delivered\n", lost);
+      passed = false;
+   }
+   return passed ? 0 : EXIT_REGRESSION;
+}
@@ -0,0 +1,176 @@
+/*
+ * Cold-start benchmark: the time from an application's first call into the library to its first window being
+ * mapped, on a headless Xvfb server.
+ *
+ * Every iteration runs in a fresh child process, so that each one opens its own connection and queries the
+ * server's extensions from scratch, exactly as an application does on launch. The child watches the root
+ * window on a connection of its own, opened before the clock starts, and stops the clock when the server
+ * reports that the window has been mapped.
+ *
+ * The process exits with 1 if the median exceeds --max-median-ms, and with 2 if the benchmark could not be
+ * set up.
+ */
+#include <sys/wait.h>
+#include <unistd.h>
+#include <xcb/xcb.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "NamelessWindow/Window.hpp"
+#include "XvfbServer.hpp"
+
+using namespace NLSWIN;
+using Clock = std::chrono::steady_clock;
+
+constexpr int EXIT_REGRESSION = 1;
+constexpr int EXIT_SETUP_FAILURE = 2;
+
+constexpr int WINDOW_WIDTH = 640;
+constexpr int WINDOW_HEIGHT = 480;
+
+struct Options {
+   bool startXvfb {true};
+   int iterations {20};
+   double maxMedianMilliseconds {0.0};
+};
+
+/*
+ * Runs in the child process. Writes the time to the first mapped window, in nanoseconds, to the pipe.
+ * @returns The exit status of the child.
+ */
+static int MeasureColdStart(int resultPipe) {
+   // With no window manager running, the server reports every top-level map to the root window.
+   xcb_connection_t *observer = xcb_connect(nullptr, nullptr);
+   if (xcb_connection_has_error(observer)) {
+      return EXIT_SETUP_FAILURE;
+   }
+   xcb_window_t root = xcb_setup_roots_iterator(xcb_get_setup(observer)).data->root;
+   uint32_t eventMask = XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY;
+   xcb_void_cookie_t selectCookie =
+      xcb_change_window_attributes_checked(observer, root, XCB_CW_EVENT_MASK, &eventMask);
+   if (xcb_generic_error_t *error = xcb_request_check(observer, selectCookie)) {
+      free(error);
+      xcb_disconnect(observer);
+      return EXIT_SETUP_FAILURE;
+   }
+
+   auto start = Clock::now();
+   WindowProperties properties;
+   properties.horzResolution = WINDOW_WIDTH;
+   properties.vertResolution = WINDOW_HEIGHT;
+   properties.windowName = "nlswin_startup";
+   auto window = Window::Create(properties);
+   window->Show();
+   bool mapped = false;
+   while (!mapped) {
+      xcb_generic_event_t *event = xcb_wait_for_event(observer);
+      if (!event) {
+         break;
+      }
+      mapped = (event->response_type & ~0x80) == XCB_MAP_NOTIFY;
+      free(event);
+   }
+   auto end = Clock::now();
+   xcb_disconnect(observer);
+   if (!mapped) {
+      return EXIT_SETUP_FAILURE;
+   }
+   int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+   bool written = write(resultPipe, &nanoseconds, sizeof(nanoseconds)) == sizeof(nanoseconds);
+   return written ? 0 : EXIT_SETUP_FAILURE;
+}
+
+/* Runs one iteration in a child process. @returns False if the child failed to measure. */
+static bool RunIteration(std::vector<double> &milliseconds) {
+   int resultPipe[2];
+   if (pipe(resultPipe) != 0) {
+      return false;
+   }
+   pid_t pid = fork();
+   if (pid < 0) {
+      return false;
+   }
+   if (pid == 0) {
+      close(resultPipe[0]);
+      // Skip the exit handlers, which belong to the parent.
+      _exit(MeasureColdStart(resultPipe[1]));
+   }
+   close(resultPipe[1]);
+   int64_t nanoseconds = 0;
+   bool received = read(resultPipe[0], &nanoseconds, sizeof(nanoseconds)) == sizeof(nanoseconds);
+   close(resultPipe[0]);
+   int status = 0;
+   waitpid(pid, &status, 0);
+   if (!received || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      return false;
+   }
+   milliseconds.push_back(nanoseconds / 1e6);
+   return true;
+}
+
+static void PrintUsage() {
+   std::printf(
+      "Usage: nlswin_startup [options]\n"
+      "  --no-xvfb                 Use the server in $DISPLAY instead of starting Xvfb\n"
+      "  --iterations <n>          Number of cold starts to measure (default 20)\n"
+      "  --max-median-ms <n>       Fail if the median time to the first mapped window is higher\n");
+}
+
+static bool ParseOptions(int argc, char **argv, Options &options) {
+   for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      if (arg == "--no-xvfb") {
+         options.startXvfb = false;
+         continue;
+      }
+      if (i + 1 >= argc) {
+         return false;
+      }
+      std::string value = argv[++i];
+      if (arg == "--iterations") {
+         options.iterations = std::atoi(value.c_str());
+      } else if (arg == "--max-median-ms") {
+         options.maxMedianMilliseconds = std::atof(value.c_str());
+      } else {
+         return false;
+      }
+   }
+   return options.iterations > 0;
+}
+
+int main(int argc, char **argv) {
+   Options options;
+   if (!ParseOptions(argc, argv, options)) {
+      PrintUsage();
+      return EXIT_SETUP_FAILURE;
+   }
+   XvfbServer server;
+   if (options.startXvfb && !server.Start()) {
+      std::fprintf(stderr, "nlswin_startup: could not start Xvfb\n");
+      return EXIT_SETUP_FAILURE;
+   }
+   // Flushed now, so that the children do not inherit and repeat anything still buffered.
+   std::fflush(stdout);
+   std::vector<double> milliseconds;
+   for (int i = 0; i < options.iterations; i++) {
+      if (!RunIteration(milliseconds)) {
+         std::fprintf(stderr, "nlswin_startup: could not connect to the X server, or no window was mapped\n");
+         return EXIT_SETUP_FAILURE;
+      }
+   }
+   std::sort(milliseconds.begin(), milliseconds.end());
+   double median = milliseconds[milliseconds.size() / 2];
+   std::printf("connect to first mapped window, %zu cold starts   ms min %8.2f p50 %8.2f max %8.2f\n",
+               milliseconds.size(), milliseconds.front(), median, milliseconds.back());
+   if (options.maxMedianMilliseconds > 0.0 && median > options.maxMedianMilliseconds) {
+      std::printf("FAIL startup_p50_ms = %.2f, threshold %.2f\n", median, options.maxMedianMilliseconds);
+      return EXIT_REGRESSION;
+   }
+   return 0;
+}
@@ -135,6 +135,9 @@ int main() {
    bgColor[1] = 0.4f;
    bgColor[2] = 0.4f;
 
+   constexpr size_t EVENT_BATCH_SIZE = 256;
+   NLSWIN::Event events[EVENT_BATCH_SIZE];
+   size_t eventCount = 0;
    while (!win->RequestedClose()) {
       std::vector<NLSWIN::KeyEvent> keyEventsThisFrame;
       NLSWIN::EventBus::PollEvents();
@@ -143,115 +146,116 @@ int main() {
          win2 = nullptr;
       }
 
-      while (win2 && win2->HasEvent()) {
-         auto evt = win2->GetNextEvent();
-         ImGui_ImplNLSWin_HandleEvent(evt);
-      }
-
-      while (win && win->HasEvent()) {
-         auto evt = win->GetNextEvent();
-         ImGui_ImplNLSWin_HandleEvent(evt);
+      if (win2) {
+         ImGui_ImplNLSWin_HandleEvents(*win2);
       }
+      ImGui_ImplNLSWin_HandleEvents(*win);
 
       int deltaX = 0;
       int deltaY = 0;
-      while (cursor->HasEvent()) {
-         auto evt = cursor->GetNextEvent();
-         ImGui_ImplNLSWin_HandleEvent(evt);
-         if (auto event = std::get_if<NLSWIN::MouseMovementEvent>(&evt)) {
-            cursorX = event->newXPos;
-            cursorY = event->newYPos;
-         }
-         if (auto event = std::get_if<NLSWIN::RawMouseDeltaMovementEvent>(&evt)) {
-            deltaX = event->deltaX;
-            deltaY = event->deltaY;
-         }
-         if (auto event = std::get_if<NLSWIN::MouseButtonEvent>(&evt)) {
-            switch (event->button) {
-               case NLSWIN::ButtonValue::LEFTCLICK: {
-                  m1Down = !(bool)event->type;
-                  break;
-               }
-               case NLSWIN::ButtonValue::RIGHTCLICK: {
-                  m2Down = !(bool)event->type;
-                  break;
-               }
-               case NLSWIN::ButtonValue::MIDDLECLICK: {
-                  m3Down = !(bool)event->type;
-                  break;
-               }
-               case NLSWIN::ButtonValue::MB_4: {
-                  m4Down = !(bool)event->type;
-                  break;
-               }
-               case NLSWIN::ButtonValue::MB_5: {
-                  m5Down = !(bool)event->type;
-                  break;
+      while ((eventCount = cursor->DrainEvents(events, EVENT_BATCH_SIZE)) > 0) {
+         for (size_t i = 0; i < eventCount; i++) {
+            auto &evt = events[i];
+            ImGui_ImplNLSWin_HandleEvent(evt);
+            if (auto event = std::get_if<NLSWIN::MouseMovementEvent>(&evt)) {
+               cursorX = event->newXPos;
+               cursorY = event->newYPos;
+            }
+            if (auto event = std::get_if<NLSWIN::RawMouseDeltaMovementEvent>(&evt)) {
+               deltaX = event->deltaX;
+               deltaY = event->deltaY;
+            }
+            if (auto event = std::get_if<NLSWIN::MouseButtonEvent>(&evt)) {
+               switch (event->button) {
+                  case NLSWIN::ButtonValue::LEFTCLICK: {
+                     m1Down = !(bool)event->type;
+                     break;
+                  }
+                  case NLSWIN::ButtonValue::RIGHTCLICK: {
+                     m2Down = !(bool)event->type;
+                     break;
+                  }
+                  case NLSWIN::ButtonValue::MIDDLECLICK: {
+                     m3Down = !(bool)event->type;
+                     break;
+                  }
+                  case NLSWIN::ButtonValue::MB_4: {
+                     m4Down = !(bool)event->type;
+                     break;
+                  }
+                  case NLSWIN::ButtonValue::MB_5: {
+                     m5Down = !(bool)event->type;
+                     break;
+                  }
                }
             }
-         }
-         if (auto event = std::get_if<NLSWIN::MouseScrollEvent>(&evt)) {
-            lastScrollDir = event->scrollType;
-         }
-         if (auto event = std::get_if<NLSWIN::MouseEnterEvent>(&evt)) {
-            cursorWithinWindow = true;
-            inWindow = event->sourceWindow;
-         }
-         if (auto event = std::get_if<NLSWIN::MouseLeaveEvent>(&evt)) {
-            cursorWithinWindow = false;
-            inWindow = 0;
+            if (auto event = std::get_if<NLSWIN::MouseScrollEvent>(&evt)) {
+               lastScrollDir = event->scrollType;
+            }
+            if (auto event = std::get_if<NLSWIN::MouseEnterEvent>(&evt)) {
+               cursorWithinWindow = true;
+               inWindow = event->sourceWindow;
+            }
+            if (auto event = std::get_if<NLSWIN::MouseLeaveEvent>(&evt)) {
+               cursorWithinWindow = false;
+               inWindow = 0;
+            }
          }
       }
       int rmDeltaX = 0;
       int rmDeltaY = 0;
-      while (rawMouse && rawMouse->HasEvent()) {
-         auto evt = rawMouse->GetNextEvent();
-         if (auto event = std::get_if<NLSWIN::RawMouseDeltaMovementEvent>(&evt)) {
-            rmDeltaX = event->deltaX;
-            rmDeltaY = event->deltaY;
-         }
-         if (auto event = std::get_if<NLSWIN::RawMouseButtonEvent>(&evt)) {
-            switch (event->button) {
-               case NLSWIN::ButtonValue::LEFTCLICK: {
-                  rm1Down = !(bool)event->type;
-                  break;
-               }
-               case NLSWIN::ButtonValue::RIGHTCLICK: {
-                  rm2Down = !(bool)event->type;
-                  break;
-               }
-               case NLSWIN::ButtonValue::MIDDLECLICK: {
-                  rm3Down = !(bool)event->type;
-                  break;
-               }
-               case NLSWIN::ButtonValue::MB_4: {
-                  rm4Down = !(bool)event->type;
-                  break;
-               }
-               case NLSWIN::ButtonValue::MB_5: {
-                  rm5Down = !(bool)event->type;
-                  break;
+      while (rawMouse && (eventCount = rawMouse->DrainEvents(events, EVENT_BATCH_SIZE)) > 0) {
+         for (size_t i = 0; i < eventCount; i++) {
+            auto &evt = events[i];
+            if (auto event = std::get_if<NLSWIN::RawMouseDeltaMovementEvent>(&evt)) {
+               rmDeltaX = event->deltaX;
+               rmDeltaY = event->deltaY;
+            }
+            if (auto event = std::get_if<NLSWIN::RawMouseButtonEvent>(&evt)) {
+               switch (event->button) {
+                  case NLSWIN::ButtonValue::LEFTCLICK: {
+                     rm1Down = !(bool)event->type;
+                     break;
+                  }
+                  case NLSWIN::ButtonValue::RIGHTCLICK: {
+                     rm2Down = !(bool)event->type;
+                     break;
+                  }
+                  case NLSWIN::ButtonValue::MIDDLECLICK: {
+                     rm3Down = !(bool)event->type;
+                     break;
+                  }
+                  case NLSWIN::ButtonValue::MB_4: {
+                     rm4Down = !(bool)event->type;
+                     break;
+                  }
+                  case NLSWIN::ButtonValue::MB_5: {
+                     rm5Down = !(bool)event->type;
+                     break;
+                  }
                }
             }
-         }
-         if (auto event = std::get_if<NLSWIN::RawMouseScrollEvent>(&evt)) {
-            rmLastScrollDir = event->scrollType;
+            if (auto event = std::get_if<NLSWIN::RawMouseScrollEvent>(&evt)) {
+               rmLastScrollDir = event->scrollType;
+            }
          }
       }
 
-      while (kb->HasEvent()) {
-         auto evt = kb->GetNextEvent();
-         ImGui_ImplNLSWin_HandleEvent(evt);
-         if (auto event = std::get_if<NLSWIN::KeyEvent>(&evt)) {
-            if ((event->code.value == NLSWIN::KeyValue::KEY_S && event->code.modifiers.ctrl &&
-                 (event->pressType == NLSWIN::KeyPressType::PRESSED))) {
-               cursor->Show();
-            }
-            if ((event->code.value == NLSWIN::KeyValue::KEY_L && event->code.modifiers.ctrl &&
-                 (event->pressType == NLSWIN::KeyPressType::PRESSED))) {
-               cursor->Confine(win.get());
+      while ((eventCount = kb->DrainEvents(events, EVENT_BATCH_SIZE)) > 0) {
+         for (size_t i = 0; i < eventCount; i++) {
+            auto &evt = events[i];
+            ImGui_ImplNLSWin_HandleEvent(evt);
+            if (auto event = std::get_if<NLSWIN::KeyEvent>(&evt)) {
+               if ((event->code.value == NLSWIN::KeyValue::KEY_S && event->code.modifiers.ctrl &&
+                    (event->pressType == NLSWIN::KeyPressType::PRESSED))) {
+                  cursor->Show();
+               }
+               if ((event->code.value == NLSWIN::KeyValue::KEY_L && event->code.modifiers.ctrl &&
+                    (event->pressType == NLSWIN::KeyPressType::PRESSED))) {
+                  cursor->Confine(win.get());
+               }
+               keyEventsThisFrame.push_back(*event);
             }
-            keyEventsThisFrame.push_back(*event);
          }
       }
 
@@ -343,10 +347,10 @@ int main() {
                   break;
             }
             NLSWIN::KeyModifiers mods = evt.code.modifiers;
-            const char *skip = &(evt.keyName.c_str()[4]);
-            log.AddLog("%-13s | %-8s | {Ctrl:%d, Shift:%d, Alt:%d, Super:%d, Caps:%d, Num:%d}\n", skip,
-                       pressType.c_str(), mods.ctrl, mods.shift, mods.alt, mods.super, mods.capsLock,
-                       mods.numLock);
+            std::string_view skip = evt.keyName.substr(4);
+            log.AddLog("%-13.*s | %-8s | {Ctrl:%d, Shift:%d, Alt:%d, Super:%d, Caps:%d, Num:%d}\n",
+                       static_cast<int>(skip.size()), skip.data(), pressType.c_str(), mods.ctrl, mods.shift,
+                       mods.alt, mods.super, mods.capsLock, mods.numLock);
          }
          log.Draw();
          keyEventsThisFrame.clear();
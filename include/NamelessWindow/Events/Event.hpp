@@ -9,7 +9,10 @@
  */
 #pragma once
 
-#include <string>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
 #include <variant>
 
 #include "../NLSAPI.hpp"
@@ -22,14 +25,34 @@ namespace NLSWIN {
 /*! Each application window is assigned one of these unique IDs. */
 using WindowID = uint32_t;
 
+/*! @brief When an event occurred, according to both the windowing system and the host.
+ *  @ingroup Common
+ *  @headerfile "Events/Event.hpp"
+ *
+ *  The server time and the host times come from unrelated clocks. Use EventClock to convert between them.
+ */
+struct NLSWIN_API_PUBLIC EventTimestamp {
+   /*! The time in milliseconds reported by the windowing system: the X server time on X11, or the message
+       time on Win32. Wraps around roughly every 49.7 days. Zero if no time was provided for the event. */
+   uint32_t serverTime {0};
+   /*! The time at which the library read the event from the windowing system. */
+   std::chrono::steady_clock::time_point captureTime {};
+   /*! The time at which the library pushed the translated event onto a listener's queue. */
+   std::chrono::steady_clock::time_point queueTime {};
+};
+
 /*! @ingroup Common */
 /*! @headerfile "Events/Event.hpp" */
 /*! Generated whenever the user interacts with a key on the keyboard. */
 struct NLSWIN_API_PUBLIC KeyEvent {
-   std::string keyName {"NULL"}; /*!< The human-readable name of the key that generated the event. */
-   KeyCode code;                 /*!< Keycode information for the event. @see KeyCode */
+   /*! The human-readable name of the key that generated the event. Refers to static storage owned by the
+       library, so it remains valid for the lifetime of the program. */
+   std::string_view keyName {"NULL"};
+   KeyCode code; /*!< Keycode information for the event. @see KeyCode */
    KeyPressType pressType {KeyPressType::UNKNOWN}; /*!< Whether this event was a press, release or repeat. */
    WindowID sourceWindow {0};                      /*!< The ID of the window that this event came from. */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @ingroup Common */
@@ -38,6 +61,8 @@ struct NLSWIN_API_PUBLIC KeyEvent {
 struct NLSWIN_API_PUBLIC CharacterEvent {
    char character;        /*!< The ASCII character that was pressed on the keyboard. */
    WindowID sourceWindow; /*!< The window that received this character. */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @ingroup Common */
@@ -50,6 +75,8 @@ struct NLSWIN_API_PUBLIC MouseButtonEvent {
    float xPos;            /*!< The X pixel coordinate where the event was generated in the source window. */
    float yPos;            /*!< The Y pixel coordinate where the event was generated in the source window. */
    WindowID sourceWindow; /*!< The ID of the window that this event came from */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @ingroup Common */
@@ -59,6 +86,8 @@ struct NLSWIN_API_PUBLIC MouseButtonEvent {
 struct NLSWIN_API_PUBLIC RawMouseButtonEvent {
    ButtonValue button;   /*!< Which button was pressed. @see ButtonValue */
    ButtonPressType type; /*!< Whether the event was a press or release. */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @ingroup Common */
@@ -70,6 +99,8 @@ struct NLSWIN_API_PUBLIC MouseScrollEvent {
    float xPos;            /*!< The X pixel coordinate where the event was generated in the source window. */
    float yPos;            /*!< The Y pixel coordinate where the event was generated in the source window. */
    WindowID sourceWindow; /*!< The ID of the window that this event came from */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @ingroup Common */
@@ -78,6 +109,8 @@ struct NLSWIN_API_PUBLIC MouseScrollEvent {
     Raw events are captured globally, inside and outside of application windows. */
 struct NLSWIN_API_PUBLIC RawMouseScrollEvent {
    ScrollType scrollType; /*!< The direction the scroll wheel was scrolled in. @see ScrollType */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @ingroup Common */
@@ -87,6 +120,8 @@ struct NLSWIN_API_PUBLIC MouseMovementEvent {
    float newXPos;         /*!< The X pixel coordinate of the new location of the cursor. */
    float newYPos;         /*!< The Y pixel coordinate of the new location of the cursor. */
    WindowID sourceWindow; /*!< The ID of the window that this event came from */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @brief Generated in response to the movement of a mouse device.
@@ -100,6 +135,8 @@ struct NLSWIN_API_PUBLIC MouseMovementEvent {
 struct NLSWIN_API_PUBLIC RawMouseDeltaMovementEvent {
    float deltaX; /*!< The raw unaccelerated delta change on the X axis.. */
    float deltaY; /*!< The raw unaccelerated delta change on the Y axis.. */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @ingroup Common */
@@ -109,6 +146,8 @@ struct NLSWIN_API_PUBLIC MouseEnterEvent {
    float xPos;            /*!< The X coordinate where the cursor entered the client area. */
    float yPos;            /*!< The Y coordinate where the cursor entered the client area. */
    WindowID sourceWindow; /*!< The window the cursor entered. */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @ingroup Common */
@@ -116,6 +155,8 @@ struct NLSWIN_API_PUBLIC MouseEnterEvent {
 /*! Generated whenever the cursor leaves the client area of any application window. */
 struct NLSWIN_API_PUBLIC MouseLeaveEvent {
    WindowID sourceWindow; /*!< The window the cursor left. */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @ingroup Common */
@@ -123,6 +164,8 @@ struct NLSWIN_API_PUBLIC MouseLeaveEvent {
 /*! Generated whenever an application window receives focus. */
 struct NLSWIN_API_PUBLIC WindowFocusedEvent {
    WindowID sourceWindow; /*!< The window that was focused. */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @ingroup Common */
@@ -130,6 +173,8 @@ struct NLSWIN_API_PUBLIC WindowFocusedEvent {
 /*! Generated whenever an application window loses focus. */
 struct NLSWIN_API_PUBLIC WindowFocusLostEvent {
    WindowID sourceWindow; /*!< The window whose focus has just been lost. */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @ingroup Common */
@@ -139,6 +184,8 @@ struct NLSWIN_API_PUBLIC WindowResizeEvent {
    int newWidth;          /*!< The new width in pixels of the application window. */
    int newHeight;         /*!< The new height in pixels of the application window. */
    WindowID sourceWindow; /*!< The window that was resized. */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! @ingroup Common */
@@ -148,6 +195,18 @@ struct NLSWIN_API_PUBLIC WindowRepositionEvent {
    int newX;              /*!< The X screen coordinate of the top-left corner of the client area. */
    int newY;              /*!< The Y screen coordinate of the top-left corner of the client area. */
    WindowID sourceWindow; /*!< The window that was moved. */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
+};
+
+/*! @ingroup Common */
+/*! @headerfile "Events/Event.hpp" */
+/*! Generated whenever monitors are connected, disconnected, rearranged or change video mode. Every
+    application window receives one per change. Call Window::EnumerateMonitors for the new monitors. */
+struct NLSWIN_API_PUBLIC MonitorsChangedEvent {
+   WindowID sourceWindow; /*!< The window that received the notification. */
+   /*! When the event occurred. */
+   EventTimestamp timestamp;
 };
 
 /*! Generic NLSWIN Event. */
@@ -156,6 +215,10 @@ struct NLSWIN_API_PUBLIC WindowRepositionEvent {
 using Event = std::variant<std::monostate, KeyEvent, WindowFocusedEvent, WindowResizeEvent, MouseButtonEvent,
                            RawMouseButtonEvent, MouseScrollEvent, RawMouseScrollEvent, MouseMovementEvent,
                            MouseEnterEvent, MouseLeaveEvent, RawMouseDeltaMovementEvent,
-                           WindowRepositionEvent, CharacterEvent, WindowFocusLostEvent>;
+                           WindowRepositionEvent, CharacterEvent, WindowFocusLostEvent,
+                           MonitorsChangedEvent>;
+
+// Events are copied into queues, coalesced and recorded byte for byte, so they must never own resources.
+static_assert(std::is_trivially_copyable_v<Event>, "All events must be trivially copyable");
 
 }  // namespace NLSWIN
\ No newline at end of file
@@ -8,6 +8,9 @@
  * @brief Documentation for public API that clients directly interact with.
  */
 #pragma once
+#include <chrono>
+#include <cstddef>
+
 #include "../NLSAPI.hpp"
 
 namespace NLSWIN {
@@ -34,5 +37,72 @@ class NLSWIN_API_PUBLIC EventBus {
     * call it once per frame in a realtime 3D application.
     */
    static void PollEvents();
+   /*!
+    * @brief Blocking retrieval of OS events. Sleeps until at least one OS event arrives, or until another
+    * thread calls Wake.
+    * @throws PlatformInitializationException
+    *
+    * Once woken, all accumulated events are dispatched exactly as if PollEvents had been called. Intended
+    * for applications that only need to redraw in response to input, such as tools and editors, which would
+    * otherwise need to spin on PollEvents or guess how long to sleep.
+    */
+   static void WaitEvents();
+   /*!
+    * @brief Blocking retrieval of OS events, with a timeout.
+    * @throws PlatformInitializationException
+    *
+    * Behaves as WaitEvents(), except that it returns after at most the given timeout even if no events have
+    * arrived. Any events that did arrive are dispatched before returning.
+    *
+    * @param timeout The maximum amount of time to sleep for.
+    */
+   static void WaitEvents(std::chrono::milliseconds timeout);
+   /*!
+    * @brief Causes a thread blocked in WaitEvents to return immediately.
+    * @throws PlatformInitializationException
+    *
+    * Safe to call from any thread. If no thread is currently blocked in WaitEvents, the next call to
+    * WaitEvents returns immediately instead.
+    */
+   static void Wake();
+   /*!
+    * @brief Limits how much work a single call to PollEvents or WaitEvents may do.
+    *
+    * By default, every event that has accumulated is dispatched before returning, so a large burst of input
+    * (or an application that has not polled for a long time) can stall a frame for as long as it takes to
+    * dispatch all of it. With a budget, dispatching stops once either limit is reached, and the remaining
+    * events are left buffered, in order, for the next call. Events are never discarded.
+    *
+    * @param maxEvents The most OS events to dispatch per call, or 0 for no limit.
+    * @param maxTime How long to keep dispatching OS events for per call, or 0 for no limit. Checked after
+    * each event, so a call may overrun it by the time taken to dispatch one event.
+    */
+   static void SetPollBudget(size_t maxEvents, std::chrono::microseconds maxTime);
+   /*!
+    * @brief Begins receiving input on a dedicated, library-owned thread.
+    * @throws PlatformInitializationException
+    *
+    * By default, OS events are only read during PollEvents and WaitEvents, so input that arrives while the
+    * application is busy (eg, rendering a frame) waits in the OS until the next call, and every event in a
+    * frame appears to have arrived at the same time. With the input thread running, keyboard and mouse input
+    * is read, translated and queued on the listeners as soon as it arrives. Window events are still only
+    * processed during PollEvents and WaitEvents, which must still be called regularly. If the connection to
+    * the server fails, the input thread exits, and the next PollEvents or WaitEvents throws.
+    *
+    * While the input thread is running, listener queues no longer grow once full. Instead, the oldest events
+    * are dropped. Events for windows are never dropped before they reach their window.
+    *
+    * On Win32, OS events are always received on a dedicated thread, so this method has no effect.
+    */
+   static void StartInputThread();
+   /*!
+    * @brief Stops the input thread started by StartInputThread, if it is running.
+    *
+    * Listener queues may grow again once it has stopped. Should be called before the application exits;
+    * otherwise the connection to the X server is shut down to stop the thread as the library unloads.
+    *
+    * On Win32, this method has no effect.
+    */
+   static void StopInputThread();
 };
 }  // namespace NLSWIN
\ No newline at end of file
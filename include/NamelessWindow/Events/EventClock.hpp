@@ -0,0 +1,60 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @addtogroup Common Public API
+ * @brief Documentation for public API that clients directly interact with.
+ */
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+#include "../NLSAPI.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @headerfile "Events/EventClock.hpp"
+ * @ingroup Common
+ * @brief Converts between the windowing system's event clock and the host's steady clock.
+ *
+ * Every Event carries an EventTimestamp with a server time and a capture time, which are measured on
+ * unrelated clocks. The library continuously calibrates a mapping between the two from the events it
+ * receives: the offset between them is estimated as the smallest difference seen over the last few seconds,
+ * which corresponds to the event that spent the least time in transit. The estimate therefore tracks slow
+ * drift between the clocks, and is accurate to within the minimum delivery latency.
+ *
+ * A typical use is measuring input latency, by comparing ServerToHost(timestamp.serverTime) against the
+ * time at which a frame reflecting that input was presented.
+ *
+ * @see EventTimestamp
+ */
+class NLSWIN_API_PUBLIC EventClock {
+   public:
+   /*!
+    * @brief Whether at least one event with a server time has been received, so that the mapping is usable.
+    *
+    * Before then, ServerToHost and HostToServer treat the two clocks as having no offset.
+    */
+   [[nodiscard]] static bool IsCalibrated() noexcept;
+   /*!
+    * @brief Converts a time on the windowing system's clock to the host's steady clock.
+    *
+    * Server times wrap around, so the conversion assumes the given time is within ~24 days of the most
+    * recently received event.
+    *
+    * @param serverTime A time in milliseconds, as found in EventTimestamp::serverTime.
+    * @return The estimated time on the host's steady clock.
+    */
+   [[nodiscard]] static std::chrono::steady_clock::time_point ServerToHost(uint32_t serverTime) noexcept;
+   /*!
+    * @brief Converts a time on the host's steady clock to the windowing system's clock.
+    *
+    * @param hostTime A time on the host's steady clock, such as EventTimestamp::captureTime.
+    * @return The estimated time in milliseconds on the windowing system's clock.
+    */
+   [[nodiscard]] static uint32_t HostToServer(std::chrono::steady_clock::time_point hostTime) noexcept;
+};
+}  // namespace NLSWIN
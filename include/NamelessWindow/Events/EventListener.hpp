@@ -9,11 +9,79 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
 #include "../NLSAPI.hpp"
 #include "Event.hpp"
+#include "InputState.hpp"
 
 namespace NLSWIN {
 
+/*!
+ * @brief A set of event types, with one bit per alternative of the Event variant.
+ * @ingroup Common
+ * @see EventListener::SetEventFilter
+ */
+using EventFilter = uint64_t;
+static_assert(std::variant_size_v<Event> <= 64, "EventFilter has too few bits for every event type");
+
+/*! @brief The filter that every listener starts out with, which lets all events through. */
+constexpr EventFilter ALL_EVENTS = ~EventFilter {0};
+
+/*! @brief The index of an event type within the Event variant, such as Event::index() would return. */
+template <typename EventType, typename Variant = Event>
+struct EventIndex;
+template <typename EventType, typename... Alternatives>
+struct EventIndex<EventType, std::variant<Alternatives...>> {
+   static constexpr size_t value = []() {
+      constexpr bool matches[] = {std::is_same_v<EventType, Alternatives>...};
+      size_t index = 0;
+      while (index < sizeof...(Alternatives) && !matches[index]) { index++; }
+      return index;
+   }();
+   static_assert(value < sizeof...(Alternatives), "The type is not an alternative of Event");
+};
+
+/*!
+ * @brief Builds an EventFilter that lets through only the given event types.
+ * @ingroup Common
+ *
+ * For example, `EventFilterOf<MouseButtonEvent, MouseScrollEvent>()`.
+ */
+template <typename... EventTypes>
+constexpr EventFilter EventFilterOf() noexcept {
+   return (EventFilter {0} | ... | (EventFilter {1} << EventIndex<EventTypes>::value));
+}
+
+/*!
+ * @brief What a listener does with new events once its queue has reached its limit.
+ * @ingroup Common
+ * @see EventListener::SetEventQueueLimit
+ */
+enum class EventQueuePolicy {
+   GROW = 0,  /*!< The queue has no limit, and grows to hold every event. The default. */
+   BLOCK = 1, /*!< Never discard events, and hold them back until the application drains the queue. */
+   DROP_OLDEST_MOTION_FIRST = 2, /*!< Discard the oldest undelivered motion event, or the oldest event. */
+   DROP_NEWEST = 3               /*!< Discard the new event. */
+};
+
+/*!
+ * @brief A snapshot of the size of a listener's queue, and how it has coped with its limit.
+ * @ingroup Common
+ * @see EventListener::GetEventQueueStats
+ */
+struct NLSWIN_API_PUBLIC EventQueueStats {
+   size_t capacity {0};        /*!< The limit on queued events, or 0 if the queue has no limit. */
+   size_t size {0};            /*!< The number of events currently queued. */
+   size_t highWaterMark {0};   /*!< The most events that have been queued at once. */
+   uint64_t droppedEvents {0}; /*!< The number of events discarded because the queue was full. */
+};
+
 /*!
  * @interface EventListener "Events/EventListener.hpp"
  * @ingroup Common
@@ -39,8 +107,194 @@ class NLSWIN_API_PUBLIC EventListener {
     * @returns The next pending event.
     */
    [[nodiscard]] virtual Event GetNextEvent() = 0;
+   /*!
+    * @brief Pop (remove) up to maxEvents pending events at once, in the order they were received.
+    *
+    * Unlike GetNextEvent, it is not an error to call this method when no events are pending.
+    *
+    * @param out Contiguous storage for at least maxEvents events, which receives the popped events.
+    * @param maxEvents The maximum number of events to pop.
+    * @post The size of the internal queue is decreased by the returned value.
+    * @returns The number of events written to out.
+    */
+   virtual size_t DrainEvents(Event *out, size_t maxEvents) = 0;
+   /*!
+    * @brief Pop (remove) every pending event, and visit each of them in the order they were received.
+    *
+    * Events are popped in batches into stack storage and passed to the visitor with std::visit, so the
+    * visitor must be callable with every event type, eg with a generic lambda.
+    *
+    * @param visitor The callable invoked on each event.
+    * @post The internal queue is empty, unless the visitor itself caused new events to be queued.
+    * @returns The number of events visited.
+    */
+   template <typename Visitor>
+   size_t DrainEvents(Visitor &&visitor) {
+      Event batch[DRAIN_BATCH_SIZE];
+      size_t total = 0;
+      size_t count = 0;
+      do {
+         count = DrainEvents(batch, DRAIN_BATCH_SIZE);
+         for (size_t i = 0; i < count; i++) { std::visit(visitor, batch[i]); }
+         total += count;
+      } while (count == DRAIN_BATCH_SIZE);
+      return total;
+   }
+   /*!
+    * @brief Enables or disables coalescing of high-frequency events. Disabled by default.
+    *
+    * While enabled, events of high-frequency streams received during a single poll are merged before they
+    * are queued: MouseMovementEvents collapse to the latest position, RawMouseDeltaMovementEvents are
+    * summed, and WindowResizeEvents collapse to the final size. Every other event is queued unchanged, and
+    * stays in order relative to the coalesced events around it. The order between two different coalesced
+    * streams (eg, cursor motion and raw deltas) is not preserved.
+    *
+    * @param enabled Whether to coalesce events.
+    */
+   virtual void SetEventCoalescing(bool enabled) = 0;
+   /*!
+    * @brief Limits the number of events this listener holds, so that memory stays flat however long the
+    * application goes without draining it (eg during a loading screen, or while a window is hidden).
+    *
+    * Once the limit is reached, new events are handled according to the policy:
+    * - EventQueuePolicy::DROP_NEWEST discards them.
+    * - EventQueuePolicy::DROP_OLDEST_MOTION_FIRST discards the oldest motion event
+    *   (MouseMovementEvent or RawMouseDeltaMovementEvent) that the application has not yet been handed,
+    *   including the new event itself, so that discrete events such as key and button releases are only
+    *   discarded once there is no motion left. Then the oldest event is discarded. An event the application
+    *   is in the middle of popping is never discarded, so a single event may briefly be held beyond the
+    *   limit until it has been popped.
+    * - EventQueuePolicy::BLOCK discards nothing. On X11, events beyond the limit are held back for this
+    *   listener alone, and released into the queue in order as the application drains it, while every other
+    *   listener keeps receiving its events. The held back events are not bounded by the limit. On Win32,
+    *   messages stop being retrieved, for every listener, until the application has drained this one, and
+    *   wait in the thread's message queue in the meantime. A replay pauses instead.
+    *
+    * If the queue holds more events than a new limit, the oldest are discarded.
+    *
+    * @param capacity The most events to hold, or 0 for no limit.
+    * @param policy What to do with events once the limit is reached. Ignored, and treated as
+    * EventQueuePolicy::GROW, if capacity is 0.
+    */
+   virtual void SetEventQueueLimit(size_t capacity, EventQueuePolicy policy) = 0;
+   /*! The current size of the queue, and its high-water mark and dropped events since the last reset. */
+   [[nodiscard]] virtual EventQueueStats GetEventQueueStats() const noexcept = 0;
+   /*! Resets the high-water mark to the current size of the queue, and the dropped events to zero. */
+   virtual void ResetEventQueueStats() noexcept = 0;
+   /*! A callback that receives events of a single type. */
+   template <typename EventType>
+   using EventCallback = std::function<void(const EventType &)>;
+   /*!
+    * @brief Delivers all future events of one type to a callback, instead of queuing them.
+    *
+    * The callback is invoked during EventBus::PollEvents (or WaitEvents) as soon as each event has been
+    * translated, so events of that type are never stored, coalesced, or wrapped in an Event variant. This is
+    * the cheapest way to consume high-frequency streams such as RawMouseDeltaMovementEvents. Events of all
+    * other types continue to be queued as usual, so the relative order of callback and queued events is not
+    * preserved.
+    *
+    * While the input thread is running (see EventBus::StartInputThread), callbacks for keyboard and mouse
+    * events are invoked on the input thread instead. A callback must not replace itself while it is running.
+    *
+    * @param callback The callback to invoke, or an empty function to go back to queuing events of this type.
+    */
+   template <typename EventType>
+   void SetEventCallback(EventCallback<EventType> callback) {
+      UpdateEventCallbacks(
+         [this, &callback]() { std::get<EventCallback<EventType>>(m_eventCallbacks) = std::move(callback); });
+   }
+
+   /*!
+    * @brief Restricts the event types this listener delivers.
+    *
+    * Events of types outside the filter are discarded before they are translated where possible, and are
+    * never queued or passed to a callback. Backends also stop requesting those events from the platform
+    * where they can, so that they are not generated at all; on X11 this shrinks the event masks selected on
+    * the X server. Events that are already queued are not affected.
+    *
+    * Filtered events do not update the InputState either. A key or button that is held while its events are
+    * filtered out is reported as held by Snapshot until it is pressed and released again once they are let
+    * through.
+    *
+    * @param filter The event types to deliver, eg from EventFilterOf. ALL_EVENTS by default.
+    */
+   void SetEventFilter(EventFilter filter) {
+      UpdateEventCallbacks([this, filter]() { m_eventFilter = filter; });
+      OnEventFilterChanged();
+   }
+   /*! The event types this listener delivers. @see SetEventFilter */
+   [[nodiscard]] EventFilter GetEventFilter() const noexcept { return m_eventFilter; }
+
+   /*!
+    * @brief Ends the current frame of input state, and returns it.
+    *
+    * Every key, button and pointer event this listener delivers, whether it is queued or passed to a
+    * callback, also updates an InputState as it is dispatched. The state is double-buffered: this method
+    * swaps the one being updated for a snapshot, which then stays unchanged until the next call. It can be
+    * read without any synchronization, even while the input thread is running. Call it once per frame,
+    * after EventBus::PollEvents.
+    *
+    * @returns Which keys and buttons are held, and what changed since the previous call. Valid until the
+    * next call.
+    */
+   const InputState &Snapshot() {
+      UpdateEventCallbacks([this]() {
+         m_inputSnapshot = m_liveInputState;
+         m_liveInputState.BeginFrame();
+      });
+      return m_inputSnapshot;
+   }
+   /*! The state returned by the last call to Snapshot. */
+   [[nodiscard]] const InputState &GetSnapshot() const noexcept { return m_inputSnapshot; }
 
    virtual ~EventListener() = default;
+
+   protected:
+   /*! Whether the event filter lets through events with the given index in the Event variant. */
+   [[nodiscard]] bool IsEventWanted(size_t eventIndex) const noexcept {
+      return (m_eventFilter >> eventIndex) & 1;
+   }
+   /*! Whether the event filter lets through events of a type. */
+   template <typename EventType>
+   [[nodiscard]] bool IsEventWanted() const noexcept {
+      return IsEventWanted(EventIndex<EventType>::value);
+   }
+   /*!
+    * @brief Called after the event filter changes, so that a backend can stop or resume requesting events
+    * from the platform. Does nothing by default.
+    */
+   virtual void OnEventFilterChanged() {}
+   /*! The callback registered for an event type, which is empty if events of that type should be queued. */
+   template <typename EventType>
+   [[nodiscard]] const EventCallback<EventType> &GetEventCallback() const noexcept {
+      return std::get<EventCallback<EventType>>(m_eventCallbacks);
+   }
+   /*! Updates the input state with an event that is being delivered. Must only be called during dispatch. */
+   template <typename EventType>
+   void TrackInputState(const EventType &event) noexcept {
+      m_liveInputState.Apply(event);
+   }
+   /*!
+    * Runs an update to the registered callbacks, the event filter or the input state while no events are
+    * being dispatched to this listener.
+    */
+   virtual void UpdateEventCallbacks(const std::function<void()> &update) = 0;
+
+   private:
+   static constexpr size_t DRAIN_BATCH_SIZE = 64;
+   template <typename Variant>
+   struct CallbackTable;
+   /*! One (possibly empty) callback per event type, skipping std::monostate. */
+   template <typename... EventTypes>
+   struct CallbackTable<std::variant<std::monostate, EventTypes...>> {
+      using Type = std::tuple<EventCallback<EventTypes>...>;
+   };
+   typename CallbackTable<Event>::Type m_eventCallbacks;
+   EventFilter m_eventFilter {ALL_EVENTS};
+   /*! Updated during dispatch. */
+   InputState m_liveInputState;
+   /*! Read by the application. */
+   InputState m_inputSnapshot;
 };
 
 }  // namespace NLSWIN
\ No newline at end of file
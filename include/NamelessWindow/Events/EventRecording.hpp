@@ -0,0 +1,120 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @addtogroup Common Public API
+ * @brief Documentation for public API that clients directly interact with.
+ */
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../NLSAPI.hpp"
+#include "Event.hpp"
+#include "EventListener.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief The kind of listener that a recorded stream of events came from.
+ * @ingroup Common
+ * @headerfile "Events/EventRecording.hpp"
+ */
+enum class RecordedSourceKind : uint32_t { UNKNOWN = 0, WINDOW = 1, KEYBOARD = 2, CURSOR = 3, RAW_MOUSE = 4 };
+
+/*!
+ * @headerfile "Events/EventRecording.hpp"
+ * @ingroup Common
+ * @brief Records every translated event, from every listener, to a binary file.
+ *
+ * Each event is written along with its EventTimestamp and the identity of the listener that produced it,
+ * whether it was queued or delivered to a callback. Recordings are replayed with EventReplay.
+ *
+ * The file is append-only: a fixed header followed by 8-byte aligned, length-prefixed records, so it can be
+ * read in place from a memory mapping, and a recording cut short by a crash is still readable up to its last
+ * complete record. Event payloads are stored in the library's in-memory layout, so recordings can only be
+ * replayed by the same version of the library on the same platform.
+ */
+class NLSWIN_API_PUBLIC EventRecorder {
+   public:
+   /*!
+    * @brief Begins recording to a file, replacing any existing file. Stops any recording already running.
+    * @throws EventRecordingException if the file cannot be created or written to.
+    *
+    * @param path The file to record to.
+    */
+   static void Start(const std::string &path);
+   /*!
+    * @brief Stops recording, and flushes the file. Does nothing if no recording is running.
+    *
+    * If writing to the file fails while recording, for example because the disk is full, recording stops
+    * at that point, IsRecording returns false, and the file holds every event up to the failure.
+    * @throws EventRecordingException if any part of the recording could not be written.
+    */
+   static void Stop();
+   [[nodiscard]] static bool IsRecording() noexcept;
+};
+
+/*!
+ * @brief A listener whose events were captured in a recording.
+ * @ingroup Common
+ * @headerfile "Events/EventRecording.hpp"
+ */
+struct NLSWIN_API_PUBLIC RecordedSource {
+   uint32_t id {0}; /*!< Unique within the recording, in the order the sources produced their first event. */
+   RecordedSourceKind kind {RecordedSourceKind::UNKNOWN}; /*!< What kind of listener produced the events. */
+   WindowID window {0}; /*!< The ID of the window, if the source was a window. */
+   /*! Receives the replayed events of this source, exactly as the original listener would have. */
+   std::shared_ptr<EventListener> listener;
+};
+
+/*!
+ * @headerfile "Events/EventRecording.hpp"
+ * @ingroup Common
+ * @brief Feeds a recording made by EventRecorder back through EventListeners, without a windowing system.
+ *
+ * Every source in the recording gets its own EventListener, which supports queues, coalescing and callbacks
+ * exactly like the listener that was recorded. Events are delivered by calling Advance, typically once per
+ * frame in place of EventBus::PollEvents. Replayed events keep their original server times, while their
+ * capture and queue times are shifted to when they were replayed, so that latency measurements of the
+ * application remain meaningful.
+ */
+class NLSWIN_API_PUBLIC EventReplay {
+   public:
+   /*!
+    * @brief Loads a recording.
+    * @throws EventRecordingException if the file cannot be read or is not a valid recording.
+    *
+    * @param path The recording to load.
+    * @return The replay, positioned at the start of the recording.
+    */
+   static std::shared_ptr<EventReplay> Open(const std::string &path);
+   /*! Every listener that produced events in the recording. */
+   [[nodiscard]] virtual const std::vector<RecordedSource> &GetSources() const noexcept = 0;
+   /*!
+    * @brief Changes the playback speed.
+    *
+    * @param speed A multiple of the original speed, eg 1 for real time or 10 to replay ten times faster. Zero
+    * or less replays without any delays, so the next call to Advance delivers the entire remaining recording.
+    */
+   virtual void SetSpeed(double speed) noexcept = 0;
+   /*!
+    * @brief Delivers every event that is due at the current playback position to its source's listener.
+    *
+    * The first call starts the playback clock.
+    *
+    * @return The number of events delivered.
+    */
+   virtual size_t Advance() = 0;
+   /*! Whether every event in the recording has been delivered. */
+   [[nodiscard]] virtual bool IsFinished() const noexcept = 0;
+   /*! Returns to the start of the recording. Events already delivered stay in their listeners' queues. */
+   virtual void Restart() noexcept = 0;
+
+   virtual ~EventReplay() = default;
+};
+}  // namespace NLSWIN
@@ -0,0 +1,165 @@
+/*!
+ * @file InputState.hpp
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @addtogroup Common Public API
+ * @brief Documentation for public API that clients directly interact with.
+ */
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <variant>
+
+#include "../NLSAPI.hpp"
+#include "Event.hpp"
+#include "InputValues.hpp"
+#include "Key.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief The state of a listener's input devices at the end of a frame, and what changed during it.
+ * @ingroup Common
+ * @headerfile "Events/InputState.hpp"
+ *
+ * Built from the same key, button and pointer events that the listener delivers, so that a game loop can
+ * query which keys and buttons are held and how far the pointer moved without draining any events. Every
+ * query takes constant time.
+ *
+ * @see EventListener::Snapshot
+ */
+class NLSWIN_API_PUBLIC InputState {
+   public:
+   /*! The number of keys that can be tracked, indexed by KeyValue. */
+   static constexpr size_t KEY_COUNT = 512;
+   /*! The number of mouse buttons that can be tracked, indexed by ButtonValue. */
+   static constexpr size_t BUTTON_COUNT = 8;
+   /*! Relative pointer motion, in the units of RawMouseDeltaMovementEvent. */
+   struct Delta {
+      float x {0};
+      float y {0};
+   };
+   /*! The absolute position of the pointer within a window. */
+   struct Position {
+      float x {0};
+      float y {0};
+      WindowID window {0}; /*!< The window the position is relative to, or 0 if none has been reported. */
+   };
+
+   /*! Whether a key is held down at the end of the frame. */
+   [[nodiscard]] bool IsDown(KeyValue key) const noexcept { return Test(m_keysDown, key); }
+   /*! Whether a mouse button is held down at the end of the frame. */
+   [[nodiscard]] bool IsDown(ButtonValue button) const noexcept { return Test(m_buttonsDown, button); }
+   /*! Whether a key was pressed during the frame, even if since released. Repeats do not count. */
+   [[nodiscard]] bool WasPressedThisFrame(KeyValue key) const noexcept { return Test(m_keysPressed, key); }
+   /*! Whether a mouse button was pressed during the frame, even if it has since been released. */
+   [[nodiscard]] bool WasPressedThisFrame(ButtonValue button) const noexcept {
+      return Test(m_buttonsPressed, button);
+   }
+   /*! Whether a key was released during the frame, even if it has since been pressed again. */
+   [[nodiscard]] bool WasReleasedThisFrame(KeyValue key) const noexcept { return Test(m_keysReleased, key); }
+   /*! Whether a mouse button was released during the frame, even if it has since been pressed again. */
+   [[nodiscard]] bool WasReleasedThisFrame(ButtonValue button) const noexcept {
+      return Test(m_buttonsReleased, button);
+   }
+   /*! The sum of all RawMouseDeltaMovementEvents during the frame. */
+   [[nodiscard]] Delta GetDelta() const noexcept { return m_delta; }
+   /*! The last position reported by a MouseMovementEvent, MouseButtonEvent or MouseEnterEvent. */
+   [[nodiscard]] Position GetPosition() const noexcept { return m_position; }
+   /*! The number of scroll steps in a direction during the frame. */
+   [[nodiscard]] int GetScrollCount(ScrollType direction) const noexcept {
+      return m_scrollCounts[static_cast<size_t>(direction)];
+   }
+
+   /*! Updates the state with an event. Events that carry no key, button or pointer state are ignored. */
+   void Apply(const Event &event) noexcept {
+      std::visit([this](const auto &alternative) { Apply(alternative); }, event);
+   }
+   void Apply(const KeyEvent &event) noexcept {
+      if (event.pressType == KeyPressType::PRESSED) {
+         Press(m_keysDown, m_keysPressed, event.code.value);
+      } else if (event.pressType == KeyPressType::RELEASED) {
+         Release(m_keysDown, m_keysReleased, event.code.value);
+      }
+   }
+   void Apply(const MouseButtonEvent &event) noexcept {
+      ApplyButton(event.button, event.type);
+      m_position = {event.xPos, event.yPos, event.sourceWindow};
+   }
+   void Apply(const RawMouseButtonEvent &event) noexcept { ApplyButton(event.button, event.type); }
+   void Apply(const MouseScrollEvent &event) noexcept {
+      m_scrollCounts[static_cast<size_t>(event.scrollType)]++;
+   }
+   void Apply(const RawMouseScrollEvent &event) noexcept {
+      m_scrollCounts[static_cast<size_t>(event.scrollType)]++;
+   }
+   void Apply(const MouseMovementEvent &event) noexcept {
+      m_position = {event.newXPos, event.newYPos, event.sourceWindow};
+   }
+   void Apply(const MouseEnterEvent &event) noexcept {
+      m_position = {event.xPos, event.yPos, event.sourceWindow};
+   }
+   void Apply(const RawMouseDeltaMovementEvent &event) noexcept {
+      m_delta.x += event.deltaX;
+      m_delta.y += event.deltaY;
+   }
+   /*! Events of any other type carry no input state. */
+   template <typename EventType>
+   void Apply(const EventType &) noexcept {}
+   /*! Begins a new frame, forgetting what changed during the last one but not what is held down. */
+   void BeginFrame() noexcept {
+      m_keysPressed.reset();
+      m_keysReleased.reset();
+      m_buttonsPressed.reset();
+      m_buttonsReleased.reset();
+      m_delta = {};
+      m_scrollCounts = {};
+   }
+
+   private:
+   std::bitset<KEY_COUNT> m_keysDown;
+   std::bitset<KEY_COUNT> m_keysPressed;
+   std::bitset<KEY_COUNT> m_keysReleased;
+   std::bitset<BUTTON_COUNT> m_buttonsDown;
+   std::bitset<BUTTON_COUNT> m_buttonsPressed;
+   std::bitset<BUTTON_COUNT> m_buttonsReleased;
+   Delta m_delta;
+   Position m_position;
+   std::array<int, 4> m_scrollCounts {};
+
+   /*! Whether a bit is set, where values outside the set (eg KEY_NULL) are never set. */
+   template <size_t Size, typename Value>
+   static bool Test(const std::bitset<Size> &bits, Value value) noexcept {
+      auto index = static_cast<size_t>(value);
+      return index < Size && bits[index];
+   }
+   template <size_t Size, typename Value>
+   static void Press(std::bitset<Size> &down, std::bitset<Size> &pressed, Value value) noexcept {
+      auto index = static_cast<size_t>(value);
+      if (index < Size) {
+         down.set(index);
+         pressed.set(index);
+      }
+   }
+   template <size_t Size, typename Value>
+   static void Release(std::bitset<Size> &down, std::bitset<Size> &released, Value value) noexcept {
+      auto index = static_cast<size_t>(value);
+      if (index < Size) {
+         down.reset(index);
+         released.set(index);
+      }
+   }
+   void ApplyButton(ButtonValue button, ButtonPressType type) noexcept {
+      if (type == ButtonPressType::PRESSED) {
+         Press(m_buttonsDown, m_buttonsPressed, button);
+      } else if (type == ButtonPressType::RELEASED) {
+         Release(m_buttonsDown, m_buttonsReleased, button);
+      }
+   }
+};
+
+}  // namespace NLSWIN
@@ -0,0 +1,101 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @addtogroup Common Public API
+ * @brief Documentation for public API that clients directly interact with.
+ */
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <variant>
+
+#include "../NLSAPI.hpp"
+#include "Event.hpp"
+#include "EventListener.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief The stages of an event's life, between which the LatencyProfiler measures elapsed time.
+ * @ingroup Common
+ * @headerfile "Events/LatencyProfiler.hpp"
+ */
+enum class LatencyStage {
+   /*! From the windowing system's timestamp to the library reading the event. Only measured for events
+       that carry a server time, and relative to the fastest delivery seen (see EventClock). */
+   SERVER_TO_READ = 0,
+   /*! From the library reading the event to the translated event being pushed onto a listener's queue. */
+   READ_TO_QUEUE = 1,
+   /*! From the event being pushed onto a listener's queue to the application retrieving it. */
+   QUEUE_TO_APP = 2
+};
+
+/*!
+ * @brief Summary of the latencies recorded for one event type and stage.
+ * @ingroup Common
+ * @headerfile "Events/LatencyProfiler.hpp"
+ *
+ * Percentiles are read from a histogram with eight buckets per power of two, so they are accurate to
+ * within 12.5%.
+ */
+struct NLSWIN_API_PUBLIC LatencyPercentiles {
+   uint64_t sampleCount {0};          /*!< The number of events measured. */
+   std::chrono::microseconds p50 {0}; /*!< Half of the measured events were at least this fast. */
+   std::chrono::microseconds p95 {0}; /*!< 95% of the measured events were at least this fast. */
+   std::chrono::microseconds p99 {0}; /*!< 99% of the measured events were at least this fast. */
+   std::chrono::microseconds max {0}; /*!< The slowest measured event. */
+};
+
+/*!
+ * @headerfile "Events/LatencyProfiler.hpp"
+ * @ingroup Common
+ * @brief Records how long events spend in each stage of their delivery, per event type.
+ *
+ * The profiler is disabled by default, in which case it costs a single branch per event. Once enabled, it
+ * keeps a histogram for every combination of event type and LatencyStage, which can be queried at any time
+ * or periodically dumped as a text report. Measurements are taken from each event's EventTimestamp, so they
+ * cover exactly the time spent inside the library and waiting for the application.
+ *
+ * @see EventTimestamp
+ */
+class NLSWIN_API_PUBLIC LatencyProfiler {
+   public:
+   /*! Receives a periodic text report. */
+   using ReportSink = std::function<void(const std::string &report)>;
+
+   /*! Begins or stops recording latencies. Recorded samples are kept when recording stops. */
+   static void SetEnabled(bool enabled) noexcept;
+   [[nodiscard]] static bool IsEnabled() noexcept;
+   /*! Discards all recorded samples. */
+   static void Reset() noexcept;
+   /*!
+    * @brief Summarises the recorded latencies of one event type in one stage.
+    *
+    * @param eventIndex The index of the event type within the Event variant, such as Event::index().
+    * @param stage The stage to summarise.
+    */
+   [[nodiscard]] static LatencyPercentiles GetPercentiles(size_t eventIndex, LatencyStage stage) noexcept;
+   /*! Summarises the recorded latencies of one event type in one stage. */
+   template <typename EventType>
+   [[nodiscard]] static LatencyPercentiles GetPercentiles(LatencyStage stage) noexcept {
+      return GetPercentiles(EventIndex<EventType>::value, stage);
+   }
+   /*! A human readable table of the percentiles of every event type and stage that has samples. */
+   [[nodiscard]] static std::string GetReport();
+   /*!
+    * @brief Dumps the report periodically while the profiler is enabled.
+    *
+    * Reports are generated on whichever thread retrieves an event once the interval has elapsed, which is
+    * normally the application's main thread.
+    *
+    * @param interval How often to dump the report, or zero to stop dumping.
+    * @param sink Receives each report. If empty, reports are written to stderr.
+    */
+   static void SetReportInterval(std::chrono::milliseconds interval, ReportSink sink = {});
+};
+}  // namespace NLSWIN
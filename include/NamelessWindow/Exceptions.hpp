@@ -112,4 +112,18 @@ class NLSWIN_API_PUBLIC InvalidVideoModeException : public std::exception {
    }
 };
 
+/*!
+ * @ingroup Common
+ * @brief Thrown when an event recording cannot be created or written, or a file is not a valid recording.
+ * @see EventRecorder
+ * @see EventReplay
+ */
+class NLSWIN_API_PUBLIC EventRecordingException : public std::exception {
+   public:
+   virtual const char* what() const noexcept override {
+      return "An event recording could not be opened or written, or is not a valid recording for this "
+             "version of the library.";
+   }
+};
+
 }  // namespace NLSWIN
\ No newline at end of file
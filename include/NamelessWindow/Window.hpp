@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <future>
 #include <memory>
 #include <optional>
 #include <string>
@@ -60,7 +61,9 @@ struct NLSWIN_API_PUBLIC MonitorInfo {
                                         * contains within it all monitors. This is relevant only
                                         * for multi-monitor setups.*/
    const std::string name {""};        /*!< Platform-specific name of the monitor. */
-   const std::vector<VideoMode> modes; /*!< A list of video modes supported by this monitor. */
+   const std::vector<VideoMode> modes; /*!< A list of video modes supported by this monitor, sorted by
+                                        * resolution, and then from the highest refresh rate to the
+                                        * lowest. */
 };
 
 /**
@@ -138,17 +141,39 @@ class NLSWIN_API_PUBLIC Window : virtual public EventListener {
    /**
     * @brief Draw the window onto the screen.
     *
-    * This method blocks until the window has been successfully drawn, if necessary. During this time,
-    * events are automatically dispatched as if the client had called EventBus::PollEvents().
+    * This method blocks until the window has been successfully drawn, if necessary, or until a short timeout
+    * passes. It sleeps until the windowing system responds rather than spinning, but events that arrive in
+    * the meantime are dispatched as if the client had called EventBus::PollEvents().
+    * @see ShowAsync
     */
    virtual void Show() = 0;
    /**
     * @brief Stop drawing the window to the screen. The window will be hidden from the user.
     *
-    * This method blocks until the window has been successfully hidden, if necessary. During this time,
-    * events are automatically dispatched as if the client had called EventBus::PollEvents().
+    * This method blocks until the window has been successfully hidden, if necessary, or until a short
+    * timeout passes. It sleeps until the windowing system responds rather than spinning, but events that
+    * arrive in the meantime are dispatched as if the client had called EventBus::PollEvents().
+    * @see HideAsync
     */
    virtual void Hide() = 0;
+   /**
+    * @brief Requests that the window be drawn onto the screen, without waiting for it to be.
+    *
+    * No events are dispatched by this method.
+    * @return A future that becomes ready once the window has been drawn. It is only made ready while events
+    * are being dispatched, by EventBus::PollEvents() or EventBus::WaitEvents(), so it must not be waited on
+    * from the thread that dispatches them. If the window is destroyed first, the future holds a
+    * std::future_error instead.
+    */
+   virtual std::shared_future<void> ShowAsync() = 0;
+   /**
+    * @brief Requests that the window be hidden from the user, without waiting for it to be.
+    *
+    * No events are dispatched by this method.
+    * @return A future that becomes ready once the window has been hidden. The same rules apply as for the
+    * future returned by ShowAsync().
+    */
+   virtual std::shared_future<void> HideAsync() = 0;
 
    /**
     * @brief Requests that the window be drawn without border decorations.
@@ -218,6 +243,26 @@ class NLSWIN_API_PUBLIC Window : virtual public EventListener {
     */
    virtual void Resize(uint32_t width, uint32_t height) = 0;
 
+   /*!
+    * @brief Switches the monitor the window is on to a new video mode.
+    * @throws InvalidVideoModeException
+    *
+    * The configuration the monitor had before the first switch is saved, and is put back by
+    * RestoreVideoMode(), by SetWindowed(), or when the window is destroyed.
+    *
+    * @param mode One of the modes listed for the monitor by EnumerateMonitors(). A mode from another monitor
+    * is matched by its resolution and refresh rate. If the monitor has no mode at that resolution, an
+    * exception is thrown.
+    */
+   virtual void SetVideoMode(const VideoMode &mode) = 0;
+
+   /*!
+    * @brief Puts back the video mode the monitor had before the first call to SetVideoMode().
+    *
+    * Does nothing if the video mode has not been changed by this window.
+    */
+   virtual void RestoreVideoMode() = 0;
+
    /*!
     * @brief Requests that the window be minimized.
     * @throws InvalidVideoModeException
@@ -0,0 +1,75 @@
+#include "ClockCalibrator.hpp"
+
+#include <algorithm>
+
+#include "NamelessWindow/Events/EventClock.hpp"
+
+using namespace NLSWIN;
+
+ClockCalibrator &ClockCalibrator::GetInstance() {
+   static ClockCalibrator instance;
+   return instance;
+}
+
+int64_t ClockCalibrator::Unwrap(uint32_t serverTime, int64_t reference) noexcept {
+   // The signed difference is correct as long as the two times are less than 2^31 ms apart.
+   return reference + static_cast<int32_t>(serverTime - static_cast<uint32_t>(reference));
+}
+
+ClockCalibrator::Nanoseconds ClockCalibrator::PublishedOffset() const noexcept {
+   return Nanoseconds(m_publishedOffset.load(std::memory_order_acquire));
+}
+
+void ClockCalibrator::Observe(uint32_t serverTime,
+                              std::chrono::steady_clock::time_point captureTime) noexcept {
+   bool calibrated = m_calibrated.load(std::memory_order_relaxed);
+   int64_t unwrapped = calibrated ? Unwrap(serverTime, m_lastServerTime) : serverTime;
+   Nanoseconds offset = captureTime.time_since_epoch() - std::chrono::milliseconds(unwrapped);
+   if (!calibrated) {
+      m_currentWindowOffset = offset;
+      m_previousWindowOffset = offset;
+      m_windowStart = captureTime;
+   } else if (captureTime - m_windowStart >= WINDOW_LENGTH) {
+      m_previousWindowOffset = m_currentWindowOffset;
+      m_currentWindowOffset = offset;
+      m_windowStart = captureTime;
+   } else {
+      m_currentWindowOffset = std::min(m_currentWindowOffset, offset);
+   }
+   m_lastServerTime = unwrapped;
+   m_publishedServerTime.store(unwrapped, std::memory_order_relaxed);
+   m_publishedOffset.store(std::min(m_currentWindowOffset, m_previousWindowOffset).count(),
+                           std::memory_order_release);
+   if (!calibrated) {
+      m_calibrated.store(true, std::memory_order_release);
+   }
+}
+
+bool ClockCalibrator::IsCalibrated() const noexcept {
+   return m_calibrated.load(std::memory_order_acquire);
+}
+
+std::chrono::steady_clock::time_point ClockCalibrator::ServerToHost(uint32_t serverTime) const noexcept {
+   int64_t reference = m_publishedServerTime.load(std::memory_order_relaxed);
+   auto hostTime = std::chrono::milliseconds(Unwrap(serverTime, reference)) + PublishedOffset();
+   return std::chrono::steady_clock::time_point(
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(hostTime));
+}
+
+uint32_t ClockCalibrator::HostToServer(std::chrono::steady_clock::time_point hostTime) const noexcept {
+   auto serverTime =
+      std::chrono::duration_cast<std::chrono::milliseconds>(hostTime.time_since_epoch() - PublishedOffset());
+   return static_cast<uint32_t>(serverTime.count());
+}
+
+bool EventClock::IsCalibrated() noexcept {
+   return ClockCalibrator::GetInstance().IsCalibrated();
+}
+
+std::chrono::steady_clock::time_point EventClock::ServerToHost(uint32_t serverTime) noexcept {
+   return ClockCalibrator::GetInstance().ServerToHost(serverTime);
+}
+
+uint32_t EventClock::HostToServer(std::chrono::steady_clock::time_point hostTime) noexcept {
+   return ClockCalibrator::GetInstance().HostToServer(hostTime);
+}
@@ -0,0 +1,101 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @brief Platform-independent utilities shared by the backend implementations.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <variant>
+
+#include "NamelessWindow/Events/Event.hpp"
+#include "NamelessWindow/NLSAPI.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief Estimates the offset between the windowing system's event clock and the host's steady clock.
+ *
+ * Each event read by a backend is observed with its server time and capture time. The difference between
+ * the two is the true offset plus however long the event took to reach us, so the smallest difference is
+ * the best estimate. Minimums are kept over two consecutive windows, so the estimate follows drift between
+ * the clocks without ever being based on less than one full window of samples.
+ *
+ * Server times are 32-bit millisecond counters, and are unwrapped into 64 bits relative to the most recent
+ * observation.
+ *
+ * Observations are made on the dispatch path, so they take no lock. The estimate is published atomically,
+ * and may be read from any thread.
+ *
+ * @see EventClock
+ */
+class NLSWIN_API_PRIVATE ClockCalibrator {
+   public:
+   /*! Singleton Accessor */
+   static ClockCalibrator &GetInstance();
+   /*!
+    * Records an event read from the windowing system at captureTime. Must only be called by one thread at a
+    * time, which the backends guarantee by only calling it while dispatching.
+    */
+   void Observe(uint32_t serverTime, std::chrono::steady_clock::time_point captureTime) noexcept;
+   bool IsCalibrated() const noexcept;
+   std::chrono::steady_clock::time_point ServerToHost(uint32_t serverTime) const noexcept;
+   uint32_t HostToServer(std::chrono::steady_clock::time_point hostTime) const noexcept;
+
+   private:
+   using Nanoseconds = std::chrono::nanoseconds;
+   static constexpr std::chrono::seconds WINDOW_LENGTH {5};
+
+   /*! The most recently observed server time, in milliseconds, unwrapped. Only read by Observe. */
+   int64_t m_lastServerTime {0};
+   /*! Host time minus server time, minimised over the current and previous windows. */
+   Nanoseconds m_currentWindowOffset {0};
+   Nanoseconds m_previousWindowOffset {0};
+   std::chrono::steady_clock::time_point m_windowStart;
+   /*! Published by Observe for readers on any thread. A reader may see one slightly older than the other. */
+   std::atomic<bool> m_calibrated {false};
+   std::atomic<int64_t> m_publishedServerTime {0};
+   std::atomic<Nanoseconds::rep> m_publishedOffset {0};
+   /*! Unwraps a server time relative to an already unwrapped one. */
+   static int64_t Unwrap(uint32_t serverTime, int64_t reference) noexcept;
+   Nanoseconds PublishedOffset() const noexcept;
+   ClockCalibrator() = default;
+   ClockCalibrator(ClockCalibrator const &) = delete;
+   void operator=(ClockCalibrator const &) = delete;
+};
+
+/*!
+ * @brief Sets the timestamp of whichever event the variant holds.
+ *
+ * Backends translate events without regard for time, and stamp them with the time of the OS event currently
+ * being dispatched as they are pushed onto a listener's queue.
+ */
+inline void StampEvent(Event &event, EventTimestamp timestamp) noexcept {
+   std::visit(
+      [timestamp](auto &alternative) {
+         if constexpr (!std::is_same_v<std::decay_t<decltype(alternative)>, std::monostate>) {
+            alternative.timestamp = timestamp;
+         }
+      },
+      event);
+}
+
+/*! @brief The timestamp of whichever event the variant holds, or an empty timestamp for std::monostate. */
+inline EventTimestamp GetTimestamp(const Event &event) noexcept {
+   return std::visit(
+      [](const auto &alternative) {
+         if constexpr (std::is_same_v<std::decay_t<decltype(alternative)>, std::monostate>) {
+            return EventTimestamp {};
+         } else {
+            return alternative.timestamp;
+         }
+      },
+      event);
+}
+
+}  // namespace NLSWIN
@@ -0,0 +1,66 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @brief Platform-independent utilities shared by the backend implementations.
+ */
+#pragma once
+
+#include <variant>
+
+#include "NamelessWindow/Events/Event.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief Whether an event belongs to a high-frequency stream that may be merged with its neighbours.
+ *
+ * Absolute cursor motion, raw mouse deltas and window resizes are coalescible. Everything else (buttons,
+ * keys, focus changes, etc) must be delivered exactly as it was received.
+ */
+inline bool IsCoalescible(const Event &event) noexcept {
+   return std::holds_alternative<MouseMovementEvent>(event) ||
+          std::holds_alternative<RawMouseDeltaMovementEvent>(event) ||
+          std::holds_alternative<WindowResizeEvent>(event);
+}
+
+/*!
+ * @brief Attempts to merge a newer event into an older, still undelivered event of the same stream.
+ *
+ * Motion collapses to the latest position, raw deltas are summed, and resizes collapse to the final size.
+ * Motion and resizes are only merged if they come from the same window. The merged event always carries the
+ * timestamp of the newest event.
+ *
+ * @param into The older event, which receives the merged result.
+ * @param next The newer event.
+ * @returns True if the events were merged, in which case next must be discarded.
+ */
+inline bool TryCoalesce(Event &into, const Event &next) noexcept {
+   if (into.index() != next.index()) {
+      return false;
+   }
+   if (auto motion = std::get_if<MouseMovementEvent>(&into)) {
+      auto nextMotion = std::get<MouseMovementEvent>(next);
+      if (motion->sourceWindow == nextMotion.sourceWindow) {
+         *motion = nextMotion;
+         return true;
+      }
+   } else if (auto delta = std::get_if<RawMouseDeltaMovementEvent>(&into)) {
+      auto nextDelta = std::get<RawMouseDeltaMovementEvent>(next);
+      delta->deltaX += nextDelta.deltaX;
+      delta->deltaY += nextDelta.deltaY;
+      delta->timestamp = nextDelta.timestamp;
+      return true;
+   } else if (auto resize = std::get_if<WindowResizeEvent>(&into)) {
+      auto nextResize = std::get<WindowResizeEvent>(next);
+      if (resize->sourceWindow == nextResize.sourceWindow) {
+         *resize = nextResize;
+         return true;
+      }
+   }
+   return false;
+}
+
+}  // namespace NLSWIN
@@ -0,0 +1,107 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @brief Platform-independent utilities shared by the backend implementations.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <variant>
+
+#include "NamelessWindow/Events/Event.hpp"
+#include "NamelessWindow/Events/EventListener.hpp"
+
+namespace NLSWIN {
+
+/*! @brief Whether an event is pointer motion, which EventQueuePolicy::DROP_OLDEST_MOTION_FIRST discards. */
+inline bool IsMotionEvent(const Event &event) noexcept {
+   return std::holds_alternative<MouseMovementEvent>(event) ||
+          std::holds_alternative<RawMouseDeltaMovementEvent>(event);
+}
+
+/*!
+ * @brief Discards the oldest motion event in a sequence of events, or the oldest event if there is none.
+ *
+ * The sequence must already include the event being pushed, so that a new motion event is discarded rather
+ * than an older event that is not motion.
+ */
+template <typename Container>
+void DiscardOldestMotionFirst(Container &events) {
+   auto motion = std::find_if(events.begin(), events.end(), IsMotionEvent);
+   events.erase(motion != events.end() ? motion : events.begin());
+}
+
+/*!
+ * @brief The high-water mark and dropped event count of a listener's queue.
+ *
+ * Updated by whichever thread pushes events, and readable from any thread.
+ */
+class EventQueueCounters {
+   public:
+   /*! Raises the high-water mark to the size of the queue after a push, if it is higher. */
+   void ObserveSize(size_t size) noexcept {
+      if (size > m_highWaterMark.load(std::memory_order_relaxed)) {
+         m_highWaterMark.store(size, std::memory_order_relaxed);
+      }
+   }
+   void CountDropped(uint64_t count = 1) noexcept {
+      m_droppedEvents.fetch_add(count, std::memory_order_relaxed);
+   }
+   void Reset(size_t size) noexcept {
+      m_highWaterMark.store(size, std::memory_order_relaxed);
+      m_droppedEvents.store(0, std::memory_order_relaxed);
+   }
+   [[nodiscard]] EventQueueStats GetStats(size_t capacity, size_t size) const noexcept {
+      return {capacity, size, m_highWaterMark.load(std::memory_order_relaxed),
+              m_droppedEvents.load(std::memory_order_relaxed)};
+   }
+
+   private:
+   std::atomic<size_t> m_highWaterMark {0};
+   std::atomic<uint64_t> m_droppedEvents {0};
+};
+
+/*!
+ * @brief Pushes an event onto a queue that only one thread pushes to and pops from, applying its limit.
+ *
+ * @param queue The queue to push onto.
+ * @param event The event to push.
+ * @param capacity The limit on queued events, or 0 if there is none.
+ * @param policy What to do once the limit has been reached.
+ * @param counters Updated with the size of the queue and any discarded events.
+ * @returns False if the queue is now over its limit under EventQueuePolicy::BLOCK, in which case the caller
+ * must stop delivering events until it has been drained.
+ */
+inline bool PushWithLimit(std::deque<Event> &queue, Event &&event, size_t capacity, EventQueuePolicy policy,
+                          EventQueueCounters &counters) {
+   if (capacity != 0 && queue.size() >= capacity && policy == EventQueuePolicy::DROP_NEWEST) {
+      counters.CountDropped();
+      return true;
+   }
+   queue.push_back(std::move(event));
+   if (capacity != 0 && queue.size() > capacity && policy == EventQueuePolicy::DROP_OLDEST_MOTION_FIRST) {
+      DiscardOldestMotionFirst(queue);
+      counters.CountDropped();
+   }
+   counters.ObserveSize(queue.size());
+   return !(policy == EventQueuePolicy::BLOCK && capacity != 0 && queue.size() > capacity);
+}
+
+/*!
+ * @brief Applies a new limit to a queue that only one thread pushes to and pops from, discarding its oldest
+ * events if it holds more than the new limit.
+ */
+inline void ApplyLimit(std::deque<Event> &queue, size_t capacity, EventQueueCounters &counters) {
+   while (capacity != 0 && queue.size() > capacity) {
+      queue.pop_front();
+      counters.CountDropped();
+   }
+}
+
+}  // namespace NLSWIN
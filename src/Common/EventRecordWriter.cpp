@@ -0,0 +1,152 @@
+#include "EventRecordWriter.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+#include "ClockCalibrator.hpp"
+#include "EventRecordingFormat.hpp"
+#include "NamelessWindow/Cursor.hpp"
+#include "NamelessWindow/Events/EventRecording.hpp"
+#include "NamelessWindow/Exceptions.hpp"
+#include "NamelessWindow/Keyboard.hpp"
+#include "NamelessWindow/RawMouse.hpp"
+#include "NamelessWindow/Window.hpp"
+
+using namespace NLSWIN;
+using namespace NLSWIN::RecordingFormat;
+
+EventRecordWriter &EventRecordWriter::GetInstance() {
+   static EventRecordWriter instance;
+   return instance;
+}
+
+EventRecordWriter::~EventRecordWriter() {
+   Close();
+}
+
+void EventRecordWriter::Start(const std::string &path) {
+   Close();
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_file = std::fopen(path.c_str(), "wb");
+   if (!m_file) {
+      throw EventRecordingException();
+   }
+   std::setvbuf(m_file, nullptr, _IOFBF, WRITE_BUFFER_SIZE);
+   FileHeader header {};
+   std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+   header.version = VERSION;
+   header.eventSize = sizeof(Event);
+   Write(&header, sizeof(header));
+   if (m_writeFailed) {
+      std::fclose(m_file);
+      m_file = nullptr;
+      m_writeFailed = false;
+      throw EventRecordingException();
+   }
+   m_startTime = std::chrono::steady_clock::now();
+   m_sourceIDs.clear();
+   m_nextSourceID = 1;
+   m_recording.store(true, std::memory_order_relaxed);
+}
+
+void EventRecordWriter::Stop() {
+   if (!Close()) {
+      throw EventRecordingException();
+   }
+}
+
+bool EventRecordWriter::Close() noexcept {
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_recording.store(false, std::memory_order_relaxed);
+   bool succeeded = !m_writeFailed;
+   m_writeFailed = false;
+   if (m_file) {
+      succeeded = std::fflush(m_file) == 0 && succeeded;
+      succeeded = std::fclose(m_file) == 0 && succeeded;
+      m_file = nullptr;
+   }
+   return succeeded;
+}
+
+void EventRecordWriter::Write(const void *data, size_t size) {
+   if (m_writeFailed) {
+      return;
+   }
+   if (std::fwrite(data, 1, size, m_file) != size) {
+      // Whatever was written before the failure is still a readable recording, so stop there rather than
+      // leave a gap in the middle of it.
+      m_writeFailed = true;
+      m_recording.store(false, std::memory_order_relaxed);
+   }
+}
+
+uint32_t EventRecordWriter::SourceIDOf(const EventListener *source) {
+   auto iter = m_sourceIDs.find(source);
+   if (iter != m_sourceIDs.end()) {
+      return iter->second;
+   }
+   SourceRecord record {};
+   record.header = {RecordType::SOURCE, sizeof(SourceRecord)};
+   record.sourceID = m_nextSourceID++;
+   RecordedSourceKind kind = RecordedSourceKind::UNKNOWN;
+   if (auto window = dynamic_cast<const Window *>(source)) {
+      kind = RecordedSourceKind::WINDOW;
+      record.window = window->GetGenericID();
+   } else if (dynamic_cast<const Keyboard *>(source)) {
+      kind = RecordedSourceKind::KEYBOARD;
+   } else if (dynamic_cast<const Cursor *>(source)) {
+      kind = RecordedSourceKind::CURSOR;
+   } else if (dynamic_cast<const RawMouse *>(source)) {
+      kind = RecordedSourceKind::RAW_MOUSE;
+   }
+   record.kind = static_cast<uint32_t>(kind);
+   Write(&record, sizeof(record));
+   m_sourceIDs.emplace(source, record.sourceID);
+   return record.sourceID;
+}
+
+void EventRecordWriter::Record(const EventListener *source, const Event &event) {
+   if (std::holds_alternative<std::monostate>(event)) {
+      return;
+   }
+   std::lock_guard<std::mutex> lock(m_mutex);
+   if (!m_file || m_writeFailed) {
+      return;
+   }
+   EventTimestamp timestamp = GetTimestamp(event);
+   alignas(RECORD_ALIGNMENT) unsigned char buffer[sizeof(EventRecord) + sizeof(Event) + RECORD_ALIGNMENT] {};
+   EventRecord record {};
+   record.sourceID = SourceIDOf(source);
+   record.eventIndex = static_cast<uint32_t>(event.index());
+   record.captureOffset = std::chrono::nanoseconds(timestamp.captureTime - m_startTime).count();
+   record.queueOffset = std::chrono::nanoseconds(timestamp.queueTime - m_startTime).count();
+   record.serverTime = timestamp.serverTime;
+   std::visit(
+      [&](const auto &alternative) {
+         if constexpr (!std::is_same_v<std::decay_t<decltype(alternative)>, std::monostate>) {
+            record.payloadSize = sizeof(alternative);
+            std::memcpy(buffer + sizeof(EventRecord), &alternative, sizeof(alternative));
+         }
+      },
+      event);
+   record.header = {RecordType::EVENT, AlignRecordSize(sizeof(EventRecord) + record.payloadSize)};
+   std::memcpy(buffer, &record, sizeof(record));
+   Write(buffer, record.header.size);
+}
+
+void EventRecordWriter::Forget(const EventListener *source) {
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_sourceIDs.erase(source);
+}
+
+void EventRecorder::Start(const std::string &path) {
+   EventRecordWriter::GetInstance().Start(path);
+}
+
+void EventRecorder::Stop() {
+   EventRecordWriter::GetInstance().Stop();
+}
+
+bool EventRecorder::IsRecording() noexcept {
+   return EventRecordWriter::GetInstance().IsRecording();
+}
@@ -0,0 +1,69 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @brief Platform-independent utilities shared by the backend implementations.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "NamelessWindow/Events/Event.hpp"
+#include "NamelessWindow/Events/EventListener.hpp"
+#include "NamelessWindow/NLSAPI.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief Backing store of the EventRecorder, fed by the backends' event listeners.
+ *
+ * Listeners are identified by address. Each listener is assigned a source ID, and declared in the file,
+ * the first time it produces an event during a recording. Listeners must call Forget when they are
+ * destroyed, so a new listener that happens to reuse the address is recorded as a new source.
+ *
+ * Records are appended from whichever thread delivers the event, so a failed write cannot be reported to the
+ * caller. Instead, the first failed write ends the recording, and the failure is reported by Stop.
+ *
+ * @see EventRecorder
+ */
+class NLSWIN_API_PRIVATE EventRecordWriter {
+   public:
+   /*! Singleton Accessor */
+   static EventRecordWriter &GetInstance();
+   inline bool IsRecording() const noexcept { return m_recording.load(std::memory_order_relaxed); }
+   void Start(const std::string &path);
+   void Stop();
+   /*! Appends an event produced by a listener. The event must already be stamped. */
+   void Record(const EventListener *source, const Event &event);
+   void Forget(const EventListener *source);
+
+   private:
+   /*! Large enough that a busy frame of input is written with a single system call. */
+   static constexpr size_t WRITE_BUFFER_SIZE = 64 * 1024;
+
+   std::atomic<bool> m_recording {false};
+   std::mutex m_mutex;
+   std::FILE *m_file {nullptr};
+   bool m_writeFailed {false};
+   std::chrono::steady_clock::time_point m_startTime;
+   std::unordered_map<const EventListener *, uint32_t> m_sourceIDs;
+   uint32_t m_nextSourceID {1};
+   uint32_t SourceIDOf(const EventListener *source);
+   void Write(const void *data, size_t size);
+   /*! Closes the file, if one is open. @returns false if any part of the recording could not be written. */
+   bool Close() noexcept;
+   EventRecordWriter() = default;
+   ~EventRecordWriter();
+   EventRecordWriter(EventRecordWriter const &) = delete;
+   void operator=(EventRecordWriter const &) = delete;
+};
+
+}  // namespace NLSWIN
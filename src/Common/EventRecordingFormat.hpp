@@ -0,0 +1,78 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @brief Platform-independent utilities shared by the backend implementations.
+ */
+#pragma once
+
+#include <cstdint>
+#include <variant>
+
+#include "NamelessWindow/Events/Event.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief On-disk layout of an event recording.
+ *
+ * A recording is a RecordingFileHeader followed by records. Every record starts with a RecordHeader giving
+ * its total size, which is always a multiple of RECORD_ALIGNMENT, so each record (and the payload inside it)
+ * is naturally aligned when the file is mapped into memory. Readers skip record types they do not know.
+ *
+ * All fields are in the host's byte order.
+ */
+namespace RecordingFormat {
+
+constexpr char MAGIC[8] = {'N', 'L', 'S', 'W', 'R', 'E', 'C', '\0'};
+/*! Bumped whenever the layout of the file or of any event struct changes. */
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t RECORD_ALIGNMENT = 8;
+
+struct FileHeader {
+   char magic[8];
+   uint32_t version;
+   /*! sizeof(Event), as a cheap check that the event structs match the library reading the file. */
+   uint32_t eventSize;
+};
+
+enum class RecordType : uint32_t { SOURCE = 1, EVENT = 2 };
+
+struct RecordHeader {
+   RecordType type;
+   uint32_t size; /*!< Of the whole record, including this header and any padding. */
+};
+
+/*! Declares a listener, before the first event it produced. */
+struct SourceRecord {
+   RecordHeader header;
+   uint32_t sourceID;
+   uint32_t kind;
+   uint32_t window;
+   uint32_t reserved;
+};
+
+/*! One translated event. Followed by payloadSize bytes of the event struct, then padding. */
+struct EventRecord {
+   RecordHeader header;
+   uint32_t sourceID;
+   uint32_t eventIndex; /*!< The index of the event type within the Event variant. */
+   /*! Nanoseconds since the recording started. */
+   int64_t captureOffset;
+   int64_t queueOffset;
+   uint32_t serverTime;
+   uint32_t payloadSize;
+};
+
+static_assert(sizeof(FileHeader) % RECORD_ALIGNMENT == 0);
+static_assert(sizeof(SourceRecord) % RECORD_ALIGNMENT == 0);
+static_assert(sizeof(EventRecord) % RECORD_ALIGNMENT == 0);
+
+constexpr uint32_t AlignRecordSize(size_t size) noexcept {
+   return static_cast<uint32_t>((size + RECORD_ALIGNMENT - 1) & ~static_cast<size_t>(RECORD_ALIGNMENT - 1));
+}
+
+}  // namespace RecordingFormat
+}  // namespace NLSWIN
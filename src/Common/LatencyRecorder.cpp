@@ -0,0 +1,238 @@
+#include "LatencyRecorder.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+
+#include "ClockCalibrator.hpp"
+#include "NamelessWindow/Events/EventClock.hpp"
+
+using namespace NLSWIN;
+
+/*! Names of the Event alternatives, in variant order. */
+static constexpr const char *EVENT_TYPE_NAMES[] = {"None",
+                                                    "KeyEvent",
+                                                    "WindowFocusedEvent",
+                                                    "WindowResizeEvent",
+                                                    "MouseButtonEvent",
+                                                    "RawMouseButtonEvent",
+                                                    "MouseScrollEvent",
+                                                    "RawMouseScrollEvent",
+                                                    "MouseMovementEvent",
+                                                    "MouseEnterEvent",
+                                                    "MouseLeaveEvent",
+                                                    "RawMouseDeltaMovementEvent",
+                                                    "WindowRepositionEvent",
+                                                    "CharacterEvent",
+                                                    "WindowFocusLostEvent",
+                                                    "MonitorsChangedEvent"};
+static_assert(std::size(EVENT_TYPE_NAMES) == std::variant_size_v<Event>, "Every event type must be named");
+
+static constexpr const char *STAGE_NAMES[] = {"server->read", "read->queue", "queue->app"};
+
+LatencyRecorder &LatencyRecorder::GetInstance() {
+   static LatencyRecorder instance;
+   return instance;
+}
+
+void LatencyRecorder::SetEnabled(bool enabled) noexcept {
+   m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void LatencyRecorder::Reset() noexcept {
+   for (auto &stage: m_histograms) {
+      for (auto &histogram: stage) {
+         for (auto &bucket: histogram.buckets) { bucket.store(0, std::memory_order_relaxed); }
+         histogram.sampleCount.store(0, std::memory_order_relaxed);
+         histogram.maxMicroseconds.store(0, std::memory_order_relaxed);
+      }
+   }
+}
+
+size_t LatencyRecorder::BucketOf(uint64_t microseconds) noexcept {
+   if (microseconds < SUB_BUCKETS) {
+      return microseconds;
+   }
+   microseconds = std::min<uint64_t>(microseconds, UINT32_MAX);
+   // The position of the highest set bit picks the power of two, the next three bits pick the sub bucket.
+   size_t exponent = 3;
+   while ((microseconds >> (exponent + 1)) != 0) { exponent++; }
+   size_t subBucket = (microseconds >> (exponent - 3)) & (SUB_BUCKETS - 1);
+   return (exponent - 2) * SUB_BUCKETS + subBucket;
+}
+
+uint64_t LatencyRecorder::BucketUpperBound(size_t bucket) noexcept {
+   if (bucket < SUB_BUCKETS) {
+      return bucket;
+   }
+   size_t exponent = bucket / SUB_BUCKETS + 2;
+   uint64_t subBucket = bucket % SUB_BUCKETS;
+   return ((SUB_BUCKETS + subBucket + 1) << (exponent - 3)) - 1;
+}
+
+void LatencyRecorder::Record(LatencyStage stage, size_t eventIndex,
+                             std::chrono::steady_clock::duration latency) noexcept {
+   auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+   uint64_t sample = static_cast<uint64_t>(std::max<int64_t>(microseconds, 0));
+   Histogram &histogram = m_histograms[static_cast<size_t>(stage)][eventIndex];
+   histogram.buckets[BucketOf(sample)].fetch_add(1, std::memory_order_relaxed);
+   histogram.sampleCount.fetch_add(1, std::memory_order_relaxed);
+   uint64_t max = histogram.maxMicroseconds.load(std::memory_order_relaxed);
+   while (sample > max &&
+          !histogram.maxMicroseconds.compare_exchange_weak(max, sample, std::memory_order_relaxed)) {}
+}
+
+void LatencyRecorder::RecordQueued(const Event &event) {
+   if (!IsEnabled() || std::holds_alternative<std::monostate>(event)) {
+      return;
+   }
+   RecordQueuedStages(event.index(), GetTimestamp(event));
+}
+
+void LatencyRecorder::RecordQueuedStages(size_t eventIndex, const EventTimestamp &timestamp) noexcept {
+   if (timestamp.serverTime != 0 && EventClock::IsCalibrated()) {
+      Record(LatencyStage::SERVER_TO_READ, eventIndex,
+             timestamp.captureTime - EventClock::ServerToHost(timestamp.serverTime));
+   }
+   Record(LatencyStage::READ_TO_QUEUE, eventIndex, timestamp.queueTime - timestamp.captureTime);
+}
+
+void LatencyRecorder::RecordCallback(size_t eventIndex, const EventTimestamp &timestamp) {
+   if (!IsEnabled()) {
+      return;
+   }
+   RecordQueuedStages(eventIndex, timestamp);
+   auto now = std::chrono::steady_clock::now();
+   Record(LatencyStage::QUEUE_TO_APP, eventIndex, now - timestamp.queueTime);
+   MaybeReport(now);
+}
+
+void LatencyRecorder::RecordDelivered(const Event *events, size_t count) {
+   if (!IsEnabled() || count == 0) {
+      return;
+   }
+   auto now = std::chrono::steady_clock::now();
+   for (size_t i = 0; i < count; i++) {
+      if (!std::holds_alternative<std::monostate>(events[i])) {
+         Record(LatencyStage::QUEUE_TO_APP, events[i].index(), now - GetTimestamp(events[i]).queueTime);
+      }
+   }
+   MaybeReport(now);
+}
+
+LatencyPercentiles LatencyRecorder::GetPercentiles(size_t eventIndex, LatencyStage stage) const noexcept {
+   LatencyPercentiles percentiles;
+   auto stageIndex = static_cast<size_t>(stage);
+   if (eventIndex >= EVENT_TYPE_COUNT || stageIndex >= STAGE_COUNT) {
+      return percentiles;
+   }
+   const Histogram &histogram = m_histograms[stageIndex][eventIndex];
+   uint64_t counts[BUCKET_COUNT];
+   uint64_t total = 0;
+   for (size_t i = 0; i < BUCKET_COUNT; i++) {
+      counts[i] = histogram.buckets[i].load(std::memory_order_relaxed);
+      total += counts[i];
+   }
+   if (total == 0) {
+      return percentiles;
+   }
+   uint64_t max = histogram.maxMicroseconds.load(std::memory_order_relaxed);
+   // The smallest bucket whose cumulative count reaches the requested fraction of all samples.
+   auto percentile = [&](uint64_t numerator) {
+      uint64_t threshold = (total * numerator + 99) / 100;
+      uint64_t cumulative = 0;
+      for (size_t i = 0; i < BUCKET_COUNT; i++) {
+         cumulative += counts[i];
+         if (cumulative >= threshold) {
+            return std::chrono::microseconds(std::min(BucketUpperBound(i), max));
+         }
+      }
+      return std::chrono::microseconds(max);
+   };
+   percentiles.sampleCount = total;
+   percentiles.p50 = percentile(50);
+   percentiles.p95 = percentile(95);
+   percentiles.p99 = percentile(99);
+   percentiles.max = std::chrono::microseconds(max);
+   return percentiles;
+}
+
+std::string LatencyRecorder::GetReport() const {
+   std::string report = "NamelessWindow input latency (microseconds)\n";
+   char line[160];
+   std::snprintf(line, sizeof(line), "%-28s %-13s %10s %9s %9s %9s %9s\n", "Event", "Stage", "Samples", "p50",
+                 "p95", "p99", "max");
+   report += line;
+   for (size_t eventIndex = 1; eventIndex < EVENT_TYPE_COUNT; eventIndex++) {
+      for (size_t stage = 0; stage < STAGE_COUNT; stage++) {
+         auto percentiles = GetPercentiles(eventIndex, static_cast<LatencyStage>(stage));
+         if (percentiles.sampleCount == 0) {
+            continue;
+         }
+         std::snprintf(line, sizeof(line), "%-28s %-13s %10llu %9lld %9lld %9lld %9lld\n",
+                       EVENT_TYPE_NAMES[eventIndex], STAGE_NAMES[stage],
+                       static_cast<unsigned long long>(percentiles.sampleCount),
+                       static_cast<long long>(percentiles.p50.count()),
+                       static_cast<long long>(percentiles.p95.count()),
+                       static_cast<long long>(percentiles.p99.count()),
+                       static_cast<long long>(percentiles.max.count()));
+         report += line;
+      }
+   }
+   return report;
+}
+
+void LatencyRecorder::SetReportInterval(std::chrono::milliseconds interval,
+                                        LatencyProfiler::ReportSink sink) {
+   std::lock_guard<std::mutex> lock(m_sinkMutex);
+   m_reportSink = std::move(sink);
+   auto ticks = std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval).count(), 0);
+   m_nextReport.store(std::chrono::steady_clock::now().time_since_epoch().count() + ticks,
+                      std::memory_order_relaxed);
+   m_reportInterval.store(ticks, std::memory_order_relaxed);
+}
+
+void LatencyRecorder::MaybeReport(std::chrono::steady_clock::time_point now) {
+   int64_t interval = m_reportInterval.load(std::memory_order_relaxed);
+   int64_t nextReport = m_nextReport.load(std::memory_order_relaxed);
+   int64_t nowTicks = now.time_since_epoch().count();
+   if (interval == 0 || nowTicks < nextReport) {
+      return;
+   }
+   // Only the thread that advances the deadline dumps the report.
+   if (!m_nextReport.compare_exchange_strong(nextReport, nowTicks + interval, std::memory_order_relaxed)) {
+      return;
+   }
+   std::string report = GetReport();
+   std::lock_guard<std::mutex> lock(m_sinkMutex);
+   if (m_reportSink) {
+      m_reportSink(report);
+   } else {
+      std::fputs(report.c_str(), stderr);
+   }
+}
+
+void LatencyProfiler::SetEnabled(bool enabled) noexcept {
+   LatencyRecorder::GetInstance().SetEnabled(enabled);
+}
+
+bool LatencyProfiler::IsEnabled() noexcept {
+   return LatencyRecorder::GetInstance().IsEnabled();
+}
+
+void LatencyProfiler::Reset() noexcept {
+   LatencyRecorder::GetInstance().Reset();
+}
+
+LatencyPercentiles LatencyProfiler::GetPercentiles(size_t eventIndex, LatencyStage stage) noexcept {
+   return LatencyRecorder::GetInstance().GetPercentiles(eventIndex, stage);
+}
+
+std::string LatencyProfiler::GetReport() {
+   return LatencyRecorder::GetInstance().GetReport();
+}
+
+void LatencyProfiler::SetReportInterval(std::chrono::milliseconds interval, ReportSink sink) {
+   LatencyRecorder::GetInstance().SetReportInterval(interval, std::move(sink));
+}
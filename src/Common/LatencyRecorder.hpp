@@ -0,0 +1,86 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @brief Platform-independent utilities shared by the backend implementations.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <variant>
+
+#include "NamelessWindow/Events/Event.hpp"
+#include "NamelessWindow/Events/LatencyProfiler.hpp"
+#include "NamelessWindow/NLSAPI.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief Backing store of the LatencyProfiler, fed by the backends' event listeners.
+ *
+ * Each (stage, event type) pair has a log-linear histogram of microseconds: exact below 8us, and eight
+ * buckets per power of two above that. All counters are relaxed atomics, so events may be recorded from the
+ * input thread and the application thread at once without locking.
+ *
+ * @see LatencyProfiler
+ */
+class NLSWIN_API_PRIVATE LatencyRecorder {
+   public:
+   /*! Singleton Accessor */
+   static LatencyRecorder &GetInstance();
+   inline bool IsEnabled() const noexcept { return m_enabled.load(std::memory_order_relaxed); }
+   void SetEnabled(bool enabled) noexcept;
+   void Reset() noexcept;
+   /*! Records the stages up to an event being pushed onto a listener's queue. The event must be stamped. */
+   void RecordQueued(const Event &event);
+   /*! Records the final stage of a batch of events that the application has just retrieved. */
+   void RecordDelivered(const Event *events, size_t count);
+   /*!
+    * Records every stage of an event handed straight to its callback, as if it had been queued and retrieved
+    * at once, without wrapping it in an Event.
+    */
+   void RecordCallback(size_t eventIndex, const EventTimestamp &timestamp);
+   LatencyPercentiles GetPercentiles(size_t eventIndex, LatencyStage stage) const noexcept;
+   std::string GetReport() const;
+   void SetReportInterval(std::chrono::milliseconds interval, LatencyProfiler::ReportSink sink);
+
+   private:
+   static constexpr size_t STAGE_COUNT = 3;
+   static constexpr size_t EVENT_TYPE_COUNT = std::variant_size_v<Event>;
+   static constexpr size_t SUB_BUCKETS = 8;
+   /*! Enough buckets for latencies of up to 2^32us, beyond which samples are clamped. */
+   static constexpr size_t BUCKET_COUNT = 31 * SUB_BUCKETS;
+
+   struct Histogram {
+      std::atomic<uint64_t> buckets[BUCKET_COUNT] {};
+      std::atomic<uint64_t> sampleCount {0};
+      std::atomic<uint64_t> maxMicroseconds {0};
+   };
+   Histogram m_histograms[STAGE_COUNT][EVENT_TYPE_COUNT];
+   std::atomic<bool> m_enabled {false};
+
+   /*! In steady clock ticks. Zero disables periodic reports. */
+   std::atomic<int64_t> m_reportInterval {0};
+   std::atomic<int64_t> m_nextReport {0};
+   std::mutex m_sinkMutex;
+   LatencyProfiler::ReportSink m_reportSink;
+
+   static size_t BucketOf(uint64_t microseconds) noexcept;
+   /*! The largest latency that falls into a bucket. */
+   static uint64_t BucketUpperBound(size_t bucket) noexcept;
+   void Record(LatencyStage stage, size_t eventIndex, std::chrono::steady_clock::duration latency) noexcept;
+   /*! Records the stages up to an event being queued, from its timestamp. */
+   void RecordQueuedStages(size_t eventIndex, const EventTimestamp &timestamp) noexcept;
+   void MaybeReport(std::chrono::steady_clock::time_point now);
+   LatencyRecorder() = default;
+   LatencyRecorder(LatencyRecorder const &) = delete;
+   void operator=(LatencyRecorder const &) = delete;
+};
+
+}  // namespace NLSWIN
@@ -0,0 +1,181 @@
+#include "RecordedEventReplay.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+
+#include "ClockCalibrator.hpp"
+#include "EventRecordingFormat.hpp"
+#include "MagicEnum/magic_enum.hpp"
+#include "NamelessWindow/Exceptions.hpp"
+
+using namespace NLSWIN;
+using namespace NLSWIN::RecordingFormat;
+
+/*!
+ * @brief Copies a payload into the event type with the given variant index.
+ * @returns False if the index is out of range, or the payload is not the size of that event type.
+ */
+template <size_t Index = 1>
+static bool DecodePayload(uint32_t eventIndex, const unsigned char *payload, uint32_t size, Event &out) {
+   if constexpr (Index < std::variant_size_v<Event>) {
+      if (eventIndex != Index) {
+         return DecodePayload<Index + 1>(eventIndex, payload, size, out);
+      }
+      using EventType = std::variant_alternative_t<Index, Event>;
+      if (size != sizeof(EventType)) {
+         return false;
+      }
+      EventType decoded;
+      std::memcpy(&decoded, payload, sizeof(EventType));
+      out = decoded;
+      return true;
+   } else {
+      return false;
+   }
+}
+
+std::shared_ptr<EventReplay> EventReplay::Open(const std::string &path) {
+   return std::make_shared<RecordedEventReplay>(path);
+}
+
+RecordedEventReplay::RecordedEventReplay(const std::string &path) {
+   Load(path);
+}
+
+void RecordedEventReplay::Load(const std::string &path) {
+   std::ifstream file(path, std::ios::binary);
+   if (!file) {
+      throw EventRecordingException();
+   }
+   FileHeader header;
+   if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+       std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+       header.eventSize != sizeof(Event)) {
+      throw EventRecordingException();
+   }
+   std::unordered_map<uint32_t, ReplayListener *> listenersByID;
+   // Large enough for any record this version writes. Only the known prefix of a larger record is read.
+   alignas(RECORD_ALIGNMENT) unsigned char buffer[sizeof(EventRecord) + sizeof(Event) + RECORD_ALIGNMENT];
+   RecordHeader recordHeader;
+   while (file.read(reinterpret_cast<char *>(&recordHeader), sizeof(recordHeader))) {
+      if (recordHeader.size < sizeof(RecordHeader) || recordHeader.size % RECORD_ALIGNMENT != 0) {
+         break;
+      }
+      bool isSource = recordHeader.type == RecordType::SOURCE && recordHeader.size >= sizeof(SourceRecord);
+      bool isEvent = recordHeader.type == RecordType::EVENT && recordHeader.size >= sizeof(EventRecord);
+      size_t remaining = recordHeader.size - sizeof(RecordHeader);
+      size_t toRead = (isSource || isEvent) ? std::min(remaining, sizeof(buffer) - sizeof(RecordHeader)) : 0;
+      std::memcpy(buffer, &recordHeader, sizeof(recordHeader));
+      // A record that runs past the end of the file was cut short, along with the recording.
+      if (!file.read(reinterpret_cast<char *>(buffer + sizeof(RecordHeader)), toRead) ||
+          !file.ignore(remaining - toRead) || static_cast<size_t>(file.gcount()) != remaining - toRead) {
+         break;
+      }
+      if (isSource) {
+         SourceRecord record;
+         std::memcpy(&record, buffer, sizeof(record));
+         auto listener = std::make_shared<ReplayListener>();
+         listenersByID[record.sourceID] = listener.get();
+         m_sources.push_back({record.sourceID, static_cast<RecordedSourceKind>(record.kind), record.window,
+                              listener});
+         m_listeners.push_back(std::move(listener));
+      } else if (isEvent) {
+         EventRecord record;
+         std::memcpy(&record, buffer, sizeof(record));
+         auto listener = listenersByID.find(record.sourceID);
+         size_t payloadCapacity = sizeof(RecordHeader) + toRead - sizeof(record);
+         if (listener == listenersByID.end() || record.payloadSize > payloadCapacity) {
+            throw EventRecordingException();
+         }
+         Event event = Decode(record, buffer + sizeof(record));
+         if (std::holds_alternative<std::monostate>(event)) {
+            throw EventRecordingException();
+         }
+         m_events.push_back({event, listener->second, record.captureOffset, record.serverTime});
+      }
+   }
+}
+
+Event RecordedEventReplay::Decode(const EventRecord &record, const unsigned char *payload) {
+   Event event;
+   if (!DecodePayload(record.eventIndex, payload, record.payloadSize, event)) {
+      return std::monostate();
+   }
+   // The recorded key name points into the memory of the process that made the recording.
+   if (auto keyEvent = std::get_if<KeyEvent>(&event)) {
+      auto name = magic_enum::enum_name(keyEvent->code.value);
+      keyEvent->keyName = (keyEvent->pressType == KeyPressType::UNKNOWN || name.empty()) ? "NULL" : name;
+   }
+   return event;
+}
+
+const std::vector<RecordedSource> &RecordedEventReplay::GetSources() const noexcept {
+   return m_sources;
+}
+
+int64_t RecordedEventReplay::Position(std::chrono::steady_clock::time_point now) const noexcept {
+   if (m_speed <= 0.0) {
+      return std::numeric_limits<int64_t>::max();
+   }
+   auto elapsed = std::chrono::nanoseconds(now - m_playbackStart).count();
+   return m_basePosition + static_cast<int64_t>(elapsed * m_speed);
+}
+
+void RecordedEventReplay::SetSpeed(double speed) noexcept {
+   // Rebase the playback clock, so that changing speed never skips or repeats part of the recording.
+   auto now = std::chrono::steady_clock::now();
+   if (m_started && m_speed > 0.0) {
+      m_basePosition = Position(now);
+   } else if (m_started && m_nextEvent < m_events.size()) {
+      m_basePosition = m_events[m_nextEvent].captureOffset;
+   }
+   m_playbackStart = now;
+   m_speed = speed;
+}
+
+size_t RecordedEventReplay::Advance() {
+   auto now = std::chrono::steady_clock::now();
+   if (!m_started && m_nextEvent < m_events.size()) {
+      // Begin with the first event, rather than with however long the recording ran before it.
+      m_started = true;
+      m_playbackStart = now;
+      m_basePosition = m_events[m_nextEvent].captureOffset;
+   }
+   int64_t position = Position(now);
+   size_t count = 0;
+   for (; m_nextEvent < m_events.size() && m_events[m_nextEvent].captureOffset <= position; m_nextEvent++) {
+      const EventEntry &entry = m_events[m_nextEvent];
+      if (entry.listener->IsBlocking()) {
+         // Resumed by a later call, once the application has drained the listener.
+         break;
+      }
+      Event event = entry.event;
+      // When the event would have been captured, had it originally happened at the playback speed.
+      EventTimestamp timestamp {entry.serverTime, now, now};
+      if (m_speed > 0.0) {
+         auto sinceStart =
+            std::chrono::nanoseconds(static_cast<int64_t>((entry.captureOffset - m_basePosition) / m_speed));
+         timestamp.captureTime =
+            m_playbackStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(sinceStart);
+      }
+      StampEvent(event, timestamp);
+      entry.listener->PushEvent(event);
+      count++;
+   }
+   for (auto &listener: m_listeners) { listener->FlushCoalescedEvents(); }
+   return count;
+}
+
+bool RecordedEventReplay::IsFinished() const noexcept {
+   return m_nextEvent >= m_events.size();
+}
+
+void RecordedEventReplay::Restart() noexcept {
+   m_nextEvent = 0;
+   m_started = false;
+}
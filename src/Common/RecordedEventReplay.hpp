@@ -0,0 +1,67 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @brief Platform-independent utilities shared by the backend implementations.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "EventRecordingFormat.hpp"
+#include "NamelessWindow/Events/EventRecording.hpp"
+#include "NamelessWindow/NLSAPI.hpp"
+#include "ReplayListener.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief Replays a recording that has been loaded into memory.
+ *
+ * The file is read one record at a time, and every event is validated and decoded as it is read, so memory
+ * grows with the number of events rather than with the size of the file. A truncated final record, as left
+ * behind by a recording that was cut short, is ignored.
+ *
+ * @see EventReplay
+ */
+class NLSWIN_API_PRIVATE RecordedEventReplay : public EventReplay {
+   public:
+   /*! @throws EventRecordingException */
+   explicit RecordedEventReplay(const std::string &path);
+   [[nodiscard]] const std::vector<RecordedSource> &GetSources() const noexcept override;
+   void SetSpeed(double speed) noexcept override;
+   size_t Advance() override;
+   [[nodiscard]] bool IsFinished() const noexcept override;
+   void Restart() noexcept override;
+
+   private:
+   struct EventEntry {
+      Event event;
+      ReplayListener *listener {nullptr};
+      int64_t captureOffset {0};
+      uint32_t serverTime {0};
+   };
+   std::vector<RecordedSource> m_sources;
+   std::vector<std::shared_ptr<ReplayListener>> m_listeners;
+   std::vector<EventEntry> m_events;
+   size_t m_nextEvent {0};
+   double m_speed {1.0};
+   bool m_started {false};
+   /*! The recording position, in nanoseconds, that corresponds to m_playbackStart. */
+   int64_t m_basePosition {0};
+   std::chrono::steady_clock::time_point m_playbackStart;
+
+   void Load(const std::string &path);
+   /*! The current recording position, in nanoseconds since the recording started. */
+   int64_t Position(std::chrono::steady_clock::time_point now) const noexcept;
+   /*! Decodes the event of a record, or returns std::monostate if its payload does not match the event. */
+   static Event Decode(const RecordingFormat::EventRecord &record, const unsigned char *payload);
+};
+
+}  // namespace NLSWIN
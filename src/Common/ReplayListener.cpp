@@ -0,0 +1,106 @@
+#include "ReplayListener.hpp"
+
+#include <type_traits>
+
+#include "EventCoalescing.hpp"
+#include "LatencyRecorder.hpp"
+#include "NamelessWindow/Exceptions.hpp"
+
+using namespace NLSWIN;
+
+bool ReplayListener::HasEvent() const noexcept {
+   return !m_Queue.empty();
+}
+
+Event ReplayListener::GetNextEvent() {
+   if (!HasEvent()) {
+      throw EmptyEventQueueException();
+   }
+   Event event = m_Queue.front();
+   m_Queue.pop_front();
+   LatencyRecorder::GetInstance().RecordDelivered(&event, 1);
+   return event;
+}
+
+size_t ReplayListener::DrainEvents(Event *out, size_t maxEvents) {
+   size_t count = 0;
+   for (; count < maxEvents && !m_Queue.empty(); count++) {
+      out[count] = m_Queue.front();
+      m_Queue.pop_front();
+   }
+   LatencyRecorder::GetInstance().RecordDelivered(out, count);
+   return count;
+}
+
+void ReplayListener::SetEventCoalescing(bool enabled) {
+   m_coalesceEvents = enabled;
+   if (!enabled) {
+      FlushCoalescedEvents();
+   }
+}
+
+void ReplayListener::UpdateEventCallbacks(const std::function<void()> &update) {
+   // Replayed events are only ever delivered from the thread that calls Advance.
+   update();
+}
+
+void ReplayListener::PushEvent(Event event) {
+   if (!IsEventWanted(event.index())) {
+      return;
+   }
+   TrackInputState(event);
+   bool deliveredToCallback = std::visit(
+      [this](const auto &alternative) {
+         using EventType = std::decay_t<decltype(alternative)>;
+         if constexpr (!std::is_same_v<EventType, std::monostate>) {
+            if (const auto &callback = GetEventCallback<EventType>(); callback) {
+               callback(alternative);
+               return true;
+            }
+         }
+         return false;
+      },
+      event);
+   if (deliveredToCallback) {
+      return;
+   }
+   if (m_coalesceEvents) {
+      if (IsCoalescible(event)) {
+         for (auto &pending: m_coalescedEvents) {
+            if (TryCoalesce(pending, event)) {
+               return;
+            }
+         }
+         m_coalescedEvents.push_back(event);
+         return;
+      }
+      // Anything else must stay behind the coalesced events that arrived before it.
+      FlushCoalescedEvents();
+   }
+   PushWithLimit(m_Queue, std::move(event), m_queueLimit, m_queuePolicy, m_queueCounters);
+}
+
+void ReplayListener::FlushCoalescedEvents() {
+   for (auto &pending: m_coalescedEvents) {
+      PushWithLimit(m_Queue, std::move(pending), m_queueLimit, m_queuePolicy, m_queueCounters);
+   }
+   m_coalescedEvents.clear();
+}
+
+bool ReplayListener::IsBlocking() const noexcept {
+   return m_queuePolicy == EventQueuePolicy::BLOCK && m_queueLimit != 0 && m_Queue.size() >= m_queueLimit;
+}
+
+void ReplayListener::SetEventQueueLimit(size_t capacity, EventQueuePolicy policy) {
+   m_queueLimit = policy == EventQueuePolicy::GROW ? 0 : capacity;
+   m_queuePolicy = m_queueLimit == 0 ? EventQueuePolicy::GROW : policy;
+   ApplyLimit(m_Queue, m_queueLimit, m_queueCounters);
+}
+
+EventQueueStats ReplayListener::GetEventQueueStats() const noexcept {
+   return m_queueCounters.GetStats(m_queueLimit, m_Queue.size());
+}
+
+void ReplayListener::ResetEventQueueStats() noexcept {
+   m_queueCounters.Reset(m_Queue.size());
+}
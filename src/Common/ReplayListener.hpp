@@ -0,0 +1,57 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @brief Platform-independent utilities shared by the backend implementations.
+ */
+#pragma once
+
+#include <functional>
+#include <deque>
+#include <vector>
+
+#include "EventQueueLimits.hpp"
+#include "NamelessWindow/Events/Event.hpp"
+#include "NamelessWindow/Events/EventListener.hpp"
+#include "NamelessWindow/NLSAPI.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief Receives the events of one recorded source during an EventReplay.
+ *
+ * Behaves like the backends' listeners: events are delivered to a registered callback if there is one, and
+ * otherwise coalesced (if enabled) and queued.
+ */
+class NLSWIN_API_PRIVATE ReplayListener : public EventListener {
+   public:
+   [[nodiscard]] bool HasEvent() const noexcept override;
+   [[nodiscard]] Event GetNextEvent() override;
+   size_t DrainEvents(Event *out, size_t maxEvents) override;
+   using EventListener::DrainEvents;
+   void SetEventCoalescing(bool enabled) override;
+   void SetEventQueueLimit(size_t capacity, EventQueuePolicy policy) override;
+   [[nodiscard]] EventQueueStats GetEventQueueStats() const noexcept override;
+   void ResetEventQueueStats() noexcept override;
+   /*! Delivers a replayed event to its callback, or pushes it onto the queue. */
+   void PushEvent(Event event);
+   /*! Moves all held back coalesced events into the queue, once a call to Advance has finished. */
+   void FlushCoalescedEvents();
+   /*! Whether the queue has reached its limit under EventQueuePolicy::BLOCK, which pauses the replay. */
+   [[nodiscard]] bool IsBlocking() const noexcept;
+
+   protected:
+   void UpdateEventCallbacks(const std::function<void()> &update) override;
+
+   private:
+   std::deque<Event> m_Queue;
+   size_t m_queueLimit {0};
+   EventQueuePolicy m_queuePolicy {EventQueuePolicy::GROW};
+   EventQueueCounters m_queueCounters;
+   bool m_coalesceEvents {false};
+   std::vector<Event> m_coalescedEvents;
+};
+
+}  // namespace NLSWIN
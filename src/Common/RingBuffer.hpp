@@ -0,0 +1,290 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @brief Platform-independent utilities shared by the backend implementations.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace NLSWIN {
+
+/*! Determines what a RingBuffer does with an element pushed while it is full. */
+enum class QueueOverflowPolicy {
+   GROW = 0,        /*!< Reallocate with twice the capacity. Only valid if one thread pushes and pops. */
+   DROP_OLDEST = 1, /*!< Discard the oldest element in the buffer to make room for the new one. */
+   DROP_NEWEST = 2  /*!< Discard the element being pushed. */
+};
+
+/*!
+ * @brief A fixed-capacity, lock-free FIFO queue.
+ *
+ * Intended for exactly one producer thread and one consumer thread. Each element is stored alongside a
+ * sequence number that tells either side whether the slot currently belongs to the producer or the consumer,
+ * so no locks are needed to hand elements over. Slots and the producer and consumer positions each occupy
+ * their own cache line to avoid false sharing between the two threads.
+ *
+ * Under QueueOverflowPolicy::DROP_OLDEST, the producer makes room by reclaiming the slot of the oldest
+ * element through its sequence number, and never moves the consumer's position. The consumer skips any slot
+ * that was reclaimed ahead of it. Should the consumer be in the middle of popping the oldest element, the
+ * producer waits for that one element rather than discarding any other. Under any policy but GROW, the
+ * producer may also discard elements itself, from anywhere in the queue, including those it tagged as
+ * expendable when pushing them. The producer and consumer then race for a slot, and the consumer claims it
+ * with a compare-and-swap before popping.
+ *
+ * @tparam T The element type. Must be default constructible and move assignable.
+ */
+template <typename T>
+class RingBuffer {
+   public:
+   static constexpr size_t CACHE_LINE_SIZE = 64;
+
+   /*!
+    * @param capacity The number of elements the buffer can hold before overflowing. Rounded up to the next
+    * power of two.
+    * @param policy What to do with elements pushed while the buffer is full.
+    */
+   explicit RingBuffer(size_t capacity, QueueOverflowPolicy policy = QueueOverflowPolicy::GROW) :
+      m_policy(policy) {
+      Allocate(capacity);
+   }
+   RingBuffer(const RingBuffer &) = delete;
+   RingBuffer &operator=(const RingBuffer &) = delete;
+
+   /*!
+    * @brief Pushes an element onto the back of the queue, applying the overflow policy if the queue is full.
+    * @returns False if the element was discarded because of the overflow policy, true otherwise.
+    */
+   bool Push(T &&value) {
+      while (!TryPush(value)) {
+         switch (m_policy) {
+            case QueueOverflowPolicy::GROW:
+               Reallocate(Capacity() * 2);
+               break;
+            case QueueOverflowPolicy::DROP_OLDEST:
+               if (!TryDiscard(m_enqueuePos.load(std::memory_order_relaxed) - Capacity())) {
+                  // The consumer is popping the oldest element, which frees its slot in a moment.
+                  std::this_thread::yield();
+               }
+               break;
+            case QueueOverflowPolicy::DROP_NEWEST:
+               return false;
+         }
+      }
+      return true;
+   }
+   /*!
+    * @brief Pushes an element onto the back of the queue, if there is room for it.
+    * @param expendable Whether TryDiscardOldestExpendable may discard the element.
+    * @returns True if the element was moved into the queue, false if the queue was full.
+    */
+   bool TryPush(T &value, bool expendable = false) {
+      // There is only ever one producer, so nobody else can move the enqueue position.
+      size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+      Cell &cell = m_cells[pos & m_mask];
+      if (cell.sequence.load(std::memory_order_acquire) != pos) {
+         return false;
+      }
+      cell.value = std::move(value);
+      cell.expendable = expendable;
+      cell.sequence.store(pos + 1, std::memory_order_release);
+      m_enqueuePos.store(pos + 1, std::memory_order_release);
+      return true;
+   }
+   /*!
+    * @brief Pops the element at the front of the queue.
+    * @param out Receives the popped element. Left untouched if the queue was empty.
+    * @returns True if an element was popped, false if the queue was empty.
+    */
+   bool TryPop(T &out) {
+      // There is only ever one consumer, so nobody else can move the dequeue position.
+      size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+      size_t skipped = 0;
+      Cell *cell = nullptr;
+      while (true) {
+         cell = &m_cells[pos & m_mask];
+         size_t sequence = cell->sequence.load(std::memory_order_acquire);
+         if (sequence == pos + 1) {
+            // The producer never reclaims the full slots of a growing queue, otherwise they must be claimed.
+            if (m_policy == QueueOverflowPolicy::GROW ||
+                cell->sequence.compare_exchange_weak(sequence, (pos + 1) | POPPING, std::memory_order_acquire,
+                                                     std::memory_order_relaxed)) {
+               break;
+            }
+         } else if (static_cast<std::ptrdiff_t>(sequence - (pos + 1)) < 0) {
+            AdvanceDequeuePos(pos, skipped);
+            return false;
+         } else {
+            // The producer reclaimed this slot first.
+            pos++;
+            skipped++;
+         }
+      }
+      AdvanceDequeuePos(pos + 1, skipped);
+      out = std::move(cell->value);
+      cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+      return true;
+   }
+   /*! Whether the queue currently holds no elements. */
+   [[nodiscard]] bool Empty() const noexcept {
+      // Slots reclaimed by the producer are skipped, the same as TryPop would.
+      for (size_t pos = m_dequeuePos.load(std::memory_order_relaxed);; pos++) {
+         size_t sequence = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire) & ~POPPING;
+         if (sequence == pos + 1) {
+            return false;
+         }
+         if (static_cast<std::ptrdiff_t>(sequence - (pos + 1)) < 0) {
+            return true;
+         }
+      }
+   }
+   /*! The number of elements in the queue. Only approximate while another thread is pushing or popping. */
+   [[nodiscard]] size_t Size() const noexcept {
+      // Reclaimed slots are counted until the consumer skips them, which advances both of its counters.
+      size_t dequeuePos = m_dequeuePos.load(std::memory_order_acquire);
+      size_t skipped = m_skippedCount.load(std::memory_order_relaxed);
+      size_t reclaimed = m_reclaimedCount.load(std::memory_order_relaxed);
+      size_t enqueuePos = m_enqueuePos.load(std::memory_order_acquire);
+      auto size = static_cast<std::ptrdiff_t>(enqueuePos - dequeuePos - reclaimed + skipped);
+      return std::min(static_cast<size_t>(std::max<std::ptrdiff_t>(size, 0)), Capacity());
+   }
+   [[nodiscard]] size_t Capacity() const noexcept { return m_mask + 1; }
+   /*!
+    * @brief Discards the oldest element that was pushed as expendable. Only called by the producer.
+    * @returns False if there is no such element that the consumer is not already popping.
+    */
+   bool TryDiscardOldestExpendable() {
+      size_t end = m_enqueuePos.load(std::memory_order_relaxed);
+      size_t pos = m_dequeuePos.load(std::memory_order_acquire);
+      // Elements before the scan position are known to be gone, or to never have been expendable.
+      if (static_cast<std::ptrdiff_t>(m_expendableScanPos - pos) > 0) {
+         pos = m_expendableScanPos;
+      }
+      for (; pos != end; pos++) {
+         // The tag of a slot that has been popped or refilled since is stale, but then so is its sequence.
+         if (m_cells[pos & m_mask].expendable && TryDiscard(pos)) {
+            m_expendableScanPos = pos + 1;
+            return true;
+         }
+      }
+      m_expendableScanPos = end;
+      return false;
+   }
+   /*!
+    * @brief Discards the oldest element in the queue. Only called by the producer.
+    * @returns False if the queue is empty, or the consumer is already popping the oldest element.
+    */
+   bool TryDiscardOldest() {
+      size_t end = m_enqueuePos.load(std::memory_order_relaxed);
+      for (size_t pos = m_dequeuePos.load(std::memory_order_acquire); pos != end; pos++) {
+         if (TryDiscard(pos)) {
+            return true;
+         }
+         if (m_cells[pos & m_mask].sequence.load(std::memory_order_relaxed) & POPPING) {
+            return false;
+         }
+      }
+      return false;
+   }
+   [[nodiscard]] QueueOverflowPolicy GetOverflowPolicy() const noexcept { return m_policy; }
+   /*!
+    * @brief Changes the capacity and overflow policy of the queue.
+    *
+    * Queued elements are preserved in order. If there are more elements than the new capacity, the oldest
+    * ones are discarded.
+    * @warning Not thread safe. Neither the producer nor the consumer may be using the queue.
+    */
+   void Configure(size_t capacity, QueueOverflowPolicy policy) {
+      m_policy = policy;
+      Reallocate(capacity);
+   }
+
+   private:
+   /*! Set in a slot's sequence number while the consumer is popping it, so that the producer leaves it be. */
+   static constexpr size_t POPPING = ~(~size_t {0} >> 1);
+   struct alignas(CACHE_LINE_SIZE) Cell {
+      std::atomic<size_t> sequence {0};
+      T value {};
+      /*! Only ever read and written by the producer. */
+      bool expendable {false};
+   };
+   alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_enqueuePos {0};
+   /*! Slots reclaimed by the producer. Only written by the producer. */
+   std::atomic<size_t> m_reclaimedCount {0};
+   alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_dequeuePos {0};
+   /*! Reclaimed slots that the consumer has since skipped. Only written by the consumer. */
+   std::atomic<size_t> m_skippedCount {0};
+   /*! Where TryDiscardOldestExpendable resumes its search. Only used by the producer. */
+   size_t m_expendableScanPos {0};
+   alignas(CACHE_LINE_SIZE) std::unique_ptr<Cell[]> m_cells;
+   size_t m_mask {0};
+   QueueOverflowPolicy m_policy {QueueOverflowPolicy::GROW};
+
+   /*!
+    * Reclaims the slot of the element at a position for the producer, unless the consumer got to it first.
+    * @returns False if the consumer is popping the element, or already has.
+    */
+   bool TryDiscard(size_t pos) {
+      Cell &cell = m_cells[pos & m_mask];
+      size_t sequence = pos + 1;
+      // Marking the slot as free for the producer's next lap is what tells the consumer to skip it.
+      if (!cell.sequence.compare_exchange_strong(sequence, pos + m_mask + 1, std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) {
+         return false;
+      }
+      m_reclaimedCount.store(m_reclaimedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return true;
+   }
+   /*! Publishes the consumer's new position, along with the reclaimed slots it skipped to get there. */
+   void AdvanceDequeuePos(size_t pos, size_t skipped) {
+      if (skipped != 0) {
+         m_skippedCount.store(m_skippedCount.load(std::memory_order_relaxed) + skipped,
+                              std::memory_order_relaxed);
+      }
+      // Released after the skipped count, so that Size never sees a position without its skipped slots.
+      m_dequeuePos.store(pos, std::memory_order_release);
+   }
+   void Allocate(size_t capacity) {
+      size_t roundedCapacity = 2;
+      while (roundedCapacity < capacity) { roundedCapacity *= 2; }
+      m_cells = std::make_unique<Cell[]>(roundedCapacity);
+      for (size_t i = 0; i < roundedCapacity; i++) {
+         m_cells[i].sequence.store(i, std::memory_order_relaxed);
+      }
+      m_mask = roundedCapacity - 1;
+      m_enqueuePos.store(0, std::memory_order_relaxed);
+      m_dequeuePos.store(0, std::memory_order_relaxed);
+      m_reclaimedCount.store(0, std::memory_order_relaxed);
+      m_skippedCount.store(0, std::memory_order_relaxed);
+      m_expendableScanPos = 0;
+   }
+   void Reallocate(size_t capacity) {
+      std::unique_ptr<Cell[]> oldCells = std::move(m_cells);
+      size_t oldMask = m_mask;
+      size_t begin = m_dequeuePos.load(std::memory_order_relaxed);
+      size_t end = m_enqueuePos.load(std::memory_order_relaxed);
+      Allocate(capacity);
+      // Reclaimed slots hold the element of a later position, or nothing, so only full slots are moved.
+      auto isFull = [&oldCells, oldMask](size_t pos) {
+         return oldCells[pos & oldMask].sequence.load(std::memory_order_relaxed) == pos + 1;
+      };
+      size_t remaining = 0;
+      for (size_t pos = begin; pos != end; pos++) { remaining += isFull(pos); }
+      for (size_t pos = begin; pos != end; pos++) {
+         // The oldest elements are discarded if there are too many for the new capacity.
+         if (isFull(pos) && remaining-- <= Capacity()) {
+            TryPush(oldCells[pos & oldMask].value, oldCells[pos & oldMask].expendable);
+         }
+      }
+   }
+};
+
+}  // namespace NLSWIN
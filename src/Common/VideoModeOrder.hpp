@@ -0,0 +1,46 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @brief Platform-independent utilities shared by the backend implementations.
+ */
+#pragma once
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include "NamelessWindow/Window.hpp"
+
+namespace NLSWIN {
+
+/*! @brief A copy of a VideoMode that can be sorted, since the members of VideoMode are const. */
+struct SortableMode {
+   int horzResolution;
+   int vertResolution;
+   float refreshRate;
+   unsigned int platformSpecificIdentifier;
+};
+
+/*! @brief Orders modes by resolution, and then from the highest refresh rate to the lowest. */
+template <typename Mode>
+bool ModeOrder(const Mode &first, const Mode &second) {
+   return std::make_tuple(first.horzResolution, first.vertResolution, -first.refreshRate) <
+          std::make_tuple(second.horzResolution, second.vertResolution, -second.refreshRate);
+}
+
+/*! @brief Sorts modes into the order that MonitorInfo::modes promises. */
+inline std::vector<VideoMode> SortVideoModes(std::vector<SortableMode> sortableModes) {
+   std::sort(sortableModes.begin(), sortableModes.end(), ModeOrder<SortableMode>);
+   std::vector<VideoMode> modes;
+   modes.reserve(sortableModes.size());
+   for (const auto &mode: sortableModes) {
+      modes.push_back(
+         {mode.horzResolution, mode.vertResolution, mode.refreshRate, mode.platformSpecificIdentifier});
+   }
+   return modes;
+}
+
+}  // namespace NLSWIN
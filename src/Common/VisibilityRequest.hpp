@@ -0,0 +1,53 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @brief Platform-independent utilities shared by the backend implementations.
+ */
+#pragma once
+
+#include <future>
+
+namespace NLSWIN {
+
+/*!
+ * @brief A request for a window to be shown or hidden, which the windowing system completes later.
+ *
+ * Repeated requests made while one is still pending share its future, since a single notification from the
+ * windowing system completes all of them.
+ */
+class VisibilityRequest {
+   public:
+   /*! The future of the pending request, starting a new request if none is pending. */
+   std::shared_future<void> Begin() {
+      if (!m_pending) {
+         m_promise = std::promise<void>();
+         m_future = m_promise.get_future().share();
+         m_pending = true;
+      }
+      return m_future;
+   }
+   /*! Makes the future of the pending request ready, if there is one. */
+   void Complete() {
+      if (m_pending) {
+         m_pending = false;
+         m_promise.set_value();
+      }
+   }
+   [[nodiscard]] bool IsPending() const noexcept { return m_pending; }
+   /*! A future that is already ready, for a request that needed no response from the windowing system. */
+   static std::shared_future<void> Completed() {
+      std::promise<void> promise;
+      promise.set_value();
+      return promise.get_future().share();
+   }
+
+   private:
+   std::promise<void> m_promise;
+   std::shared_future<void> m_future;
+   bool m_pending {false};
+};
+
+}  // namespace NLSWIN
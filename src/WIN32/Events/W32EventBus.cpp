@@ -2,7 +2,12 @@
 
 #include <windows.h>
 
+#include <algorithm>
+#include <limits>
+
+#include "../../Common/ClockCalibrator.hpp"
 #include "../W32DllMain.hpp"
+#include "NamelessWindow/Exceptions.hpp"
 #include "W32EventThreadDispatcher.hpp"
 
 using namespace NLSWIN;
@@ -12,6 +17,17 @@ W32EventBus &W32EventBus::GetInstance() {
    return instance;
 }
 
+W32EventBus::W32EventBus() {
+   m_wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+   if (!m_wakeEvent) {
+      throw PlatformInitializationException();
+   }
+}
+
+W32EventBus::~W32EventBus() {
+   CloseHandle(m_wakeEvent);
+}
+
 void W32EventBus::FreeOldEvents() {
    for (auto wParam: m_eventsToFreeNextPoll) { free(wParam); }
    m_eventsToFreeNextPoll.clear();
@@ -20,10 +36,24 @@ void W32EventBus::FreeOldEvents() {
 void W32EventBus::PollEvents() {
    // The WPARAMs we received last call  MUST be freed at the start of the next next call!
    FreeOldEvents();
+   m_stalled = std::any_of(m_listeners.begin(), m_listeners.end(), [](const auto &listener) {
+      auto listenerSharedPtr = listener.lock();
+      return listenerSharedPtr && listenerSharedPtr->IsBlocking();
+   });
+   size_t remaining = m_pollBudgetEvents != 0 ? m_pollBudgetEvents : std::numeric_limits<size_t>::max();
+   auto deadline = std::chrono::steady_clock::time_point::max();
+   if (m_pollBudgetTime.count() != 0) {
+      deadline = std::chrono::steady_clock::now() + m_pollBudgetTime;
+   }
    MSG event;
-   while (PeekMessageA(&event, 0, 0, 0, PM_REMOVE)) {
+   // Messages left over once the budget runs out stay in the thread's message queue for the next poll.
+   while (!m_stalled && remaining-- != 0 && m_currentTimestamp.captureTime < deadline &&
+          PeekMessageA(&event, 0, 0, 0, PM_REMOVE)) {
       WParamWithWindowHandle *wParam = reinterpret_cast<WParamWithWindowHandle *>(event.wParam);
       m_eventsToFreeNextPoll.push_back(wParam);
+      // Message times share a clock with GetTickCount, and are the closest Win32 has to a server time.
+      m_currentTimestamp = {static_cast<uint32_t>(event.time), std::chrono::steady_clock::now()};
+      ClockCalibrator::GetInstance().Observe(m_currentTimestamp.serverTime, m_currentTimestamp.captureTime);
       TranslateMessage(&event);
       for (auto iter = m_listeners.begin(); iter != m_listeners.end();) {
          if (!(*iter).expired()) {
@@ -39,6 +69,27 @@ void W32EventBus::PollEvents() {
       // being called, so we must always call it.
       DispatchMessage(&event);
    }
+   for (auto &listener: m_listeners) {
+      if (auto listenerSharedPtr = listener.lock()) {
+         listenerSharedPtr->FlushCoalescedEvents();
+      }
+   }
+}
+
+void W32EventBus::WaitEvents(DWORD timeoutMilliseconds) {
+   // MWMO_INPUTAVAILABLE returns immediately if messages are already queued, even ones that a previous
+   // PeekMessage has already seen.
+   MsgWaitForMultipleObjectsEx(1, &m_wakeEvent, timeoutMilliseconds, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+   PollEvents();
+}
+
+void W32EventBus::Wake() {
+   SetEvent(m_wakeEvent);
+}
+
+void W32EventBus::SetPollBudget(size_t maxEvents, std::chrono::microseconds maxTime) {
+   m_pollBudgetEvents = maxEvents;
+   m_pollBudgetTime = std::max(maxTime, std::chrono::microseconds(0));
 }
 
 void W32EventBus::RegisterListener(std::weak_ptr<W32EventListener> listener) {
@@ -49,4 +100,29 @@ void W32EventBus::RegisterListener(std::weak_ptr<W32EventListener> listener) {
 
 void EventBus::PollEvents() {
    W32EventBus::GetInstance().PollEvents();
-}
\ No newline at end of file
+}
+
+void EventBus::WaitEvents() {
+   W32EventBus::GetInstance().WaitEvents(INFINITE);
+}
+
+void EventBus::WaitEvents(std::chrono::milliseconds timeout) {
+   // INFINITE is the largest DWORD, so stay below it to keep the timeout finite.
+   auto clampedTimeout = std::min<std::chrono::milliseconds::rep>(
+      std::max<std::chrono::milliseconds::rep>(timeout.count(), 0), INFINITE - 1);
+   W32EventBus::GetInstance().WaitEvents(static_cast<DWORD>(clampedTimeout));
+}
+
+void EventBus::Wake() {
+   W32EventBus::GetInstance().Wake();
+}
+
+void EventBus::SetPollBudget(size_t maxEvents, std::chrono::microseconds maxTime) {
+   W32EventBus::GetInstance().SetPollBudget(maxEvents, maxTime);
+}
+
+void EventBus::StartInputThread() {
+   // Win32 messages are always received by the W32EventThreadDispatcher thread.
+}
+
+void EventBus::StopInputThread() {}
\ No newline at end of file
@@ -9,6 +9,7 @@
  */
 
 #pragma once
+#include <chrono>
 #include <memory>
 #include <vector>
 
@@ -27,14 +28,43 @@ class NLSWIN_API_PRIVATE W32EventBus {
    /*! Singleton Accessor */
    static W32EventBus &GetInstance();
    void PollEvents();
+   /*!
+    * @brief Sleeps until a message arrives on the main thread, the timeout expires, or Wake is called, and
+    * then dispatches all queued messages.
+    *
+    * @param timeoutMilliseconds The maximum time to sleep for, or INFINITE.
+    */
+   void WaitEvents(DWORD timeoutMilliseconds);
+   /*! Wakes a thread blocked in WaitEvents. Safe to call from any thread. */
+   void Wake();
+   /*! Limits the messages dispatched by each poll. @see EventBus::SetPollBudget */
+   void SetPollBudget(size_t maxEvents, std::chrono::microseconds maxTime);
+
+   /*! The message time of the message currently being dispatched, and when it was retrieved. */
+   inline EventTimestamp GetCurrentTimestamp() const noexcept { return m_currentTimestamp; }
 
    /*! Adds a new listener to the list of registered listeners */
    void RegisterListener(std::weak_ptr<W32EventListener> listener);
+   /*!
+    * @brief Stops retrieving messages until the next poll, because a listener has reached its queue limit
+    * under EventQueuePolicy::BLOCK. Messages are left in the thread's message queue in the meantime.
+    */
+   inline void Stall() noexcept { m_stalled = true; }
 
    private:
+   W32EventBus();
+   ~W32EventBus();
    void FreeOldEvents();
+   /*! Auto-reset event signalled by Wake. */
+   HANDLE m_wakeEvent {nullptr};
    std::vector<std::weak_ptr<W32EventListener>> m_listeners;
    std::vector<WParamWithWindowHandle *> m_eventsToFreeNextPoll;
+   EventTimestamp m_currentTimestamp;
+   bool m_stalled {false};
+   /*! The most messages to retrieve per poll, or 0 for no limit. */
+   size_t m_pollBudgetEvents {0};
+   /*! How long to keep retrieving messages per poll, or 0 for no limit. */
+   std::chrono::microseconds m_pollBudgetTime {0};
 };
 
 }  // namespace NLSWIN
\ No newline at end of file
@@ -1,9 +1,22 @@
 #include "W32EventListener.hpp"
 
+#include <chrono>
+
+#include "../../Common/ClockCalibrator.hpp"
+#include "../../Common/EventCoalescing.hpp"
+#include "../../Common/EventRecordWriter.hpp"
+#include "../../Common/LatencyRecorder.hpp"
 #include "NamelessWindow/Exceptions.hpp"
+#include "W32EventBus.hpp"
 
 using namespace NLSWIN;
 
+NLSWIN::W32EventListener::~W32EventListener() {
+   if (EventRecordWriter::GetInstance().IsRecording()) {
+      EventRecordWriter::GetInstance().Forget(this);
+   }
+}
+
 bool NLSWIN::W32EventListener::HasEvent() const noexcept {
    return !m_Queue.empty();
 }
@@ -12,10 +25,94 @@ NLSWIN::Event NLSWIN::W32EventListener::GetNextEvent() {
       throw EmptyEventQueueException();
    }
    Event test = std::move(m_Queue.front());
-   m_Queue.pop();
+   m_Queue.pop_front();
+   LatencyRecorder::GetInstance().RecordDelivered(&test, 1);
    return test;
 }
 
+size_t NLSWIN::W32EventListener::DrainEvents(Event *out, size_t maxEvents) {
+   size_t count = 0;
+   for (; count < maxEvents && !m_Queue.empty(); count++) {
+      out[count] = std::move(m_Queue.front());
+      m_Queue.pop_front();
+   }
+   LatencyRecorder::GetInstance().RecordDelivered(out, count);
+   return count;
+}
+
 void NLSWIN::W32EventListener::PushEvent(Event event) {
-   m_Queue.push(event);
+   if (!IsEventWanted(event.index())) {
+      return;
+   }
+   StampEvent(event, CurrentTimestamp());
+   RecordEvent(event);
+   TrackInputState(event);
+   LatencyRecorder::GetInstance().RecordQueued(event);
+   if (m_coalesceEvents) {
+      if (IsCoalescible(event)) {
+         for (auto &pending: m_coalescedEvents) {
+            if (TryCoalesce(pending, event)) {
+               return;
+            }
+         }
+         m_coalescedEvents.push_back(std::move(event));
+         return;
+      }
+      // Anything else must stay behind the coalesced events that arrived before it.
+      FlushCoalescedEvents();
+   }
+   Enqueue(std::move(event));
+}
+
+void NLSWIN::W32EventListener::Enqueue(Event &&event) {
+   if (!PushWithLimit(m_Queue, std::move(event), m_queueLimit, m_queuePolicy, m_queueCounters)) {
+      W32EventBus::GetInstance().Stall();
+   }
+}
+
+bool NLSWIN::W32EventListener::IsBlocking() const noexcept {
+   return m_queuePolicy == EventQueuePolicy::BLOCK && m_queueLimit != 0 && m_Queue.size() >= m_queueLimit;
+}
+
+void NLSWIN::W32EventListener::SetEventQueueLimit(size_t capacity, EventQueuePolicy policy) {
+   m_queueLimit = policy == EventQueuePolicy::GROW ? 0 : capacity;
+   m_queuePolicy = m_queueLimit == 0 ? EventQueuePolicy::GROW : policy;
+   ApplyLimit(m_Queue, m_queueLimit, m_queueCounters);
+}
+
+EventQueueStats NLSWIN::W32EventListener::GetEventQueueStats() const noexcept {
+   return m_queueCounters.GetStats(m_queueLimit, m_Queue.size());
+}
+
+void NLSWIN::W32EventListener::ResetEventQueueStats() noexcept {
+   m_queueCounters.Reset(m_Queue.size());
+}
+
+void NLSWIN::W32EventListener::RecordEvent(const Event &event) const {
+   if (EventRecordWriter::GetInstance().IsRecording()) {
+      EventRecordWriter::GetInstance().Record(this, event);
+   }
+}
+
+EventTimestamp NLSWIN::W32EventListener::CurrentTimestamp() const {
+   EventTimestamp timestamp = W32EventBus::GetInstance().GetCurrentTimestamp();
+   timestamp.queueTime = std::chrono::steady_clock::now();
+   return timestamp;
+}
+
+void NLSWIN::W32EventListener::UpdateEventCallbacks(const std::function<void()> &update) {
+   // Events are only ever dispatched from the thread that calls PollEvents.
+   update();
+}
+
+void NLSWIN::W32EventListener::FlushCoalescedEvents() {
+   for (auto &pending: m_coalescedEvents) { Enqueue(std::move(pending)); }
+   m_coalescedEvents.clear();
+}
+
+void NLSWIN::W32EventListener::SetEventCoalescing(bool enabled) {
+   m_coalesceEvents = enabled;
+   if (!enabled) {
+      FlushCoalescedEvents();
+   }
 }
\ No newline at end of file
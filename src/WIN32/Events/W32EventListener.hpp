@@ -11,8 +11,12 @@
 #pragma once
 #include <windows.h>
 
-#include <queue>
+#include <functional>
+#include <deque>
+#include <vector>
 
+#include "../../Common/EventQueueLimits.hpp"
+#include "../../Common/LatencyRecorder.hpp"
 #include "NamelessWindow/Events/EventListener.hpp"
 #include "NamelessWindow/NLSAPI.hpp"
 
@@ -21,6 +25,12 @@ class NLSWIN_API_PRIVATE W32EventListener : public virtual EventListener {
    public:
    [[nodiscard]] bool HasEvent() const noexcept override;
    [[nodiscard]] Event GetNextEvent() override;
+   size_t DrainEvents(Event *out, size_t maxEvents) override;
+   using EventListener::DrainEvents;
+   void SetEventCoalescing(bool enabled) override;
+   void SetEventQueueLimit(size_t capacity, EventQueuePolicy policy) override;
+   [[nodiscard]] EventQueueStats GetEventQueueStats() const noexcept override;
+   void ResetEventQueueStats() noexcept override;
 
    /*!
     * @brief Takes a Win32 event received from the EventBus, and either constructs a platform-independent
@@ -30,6 +40,8 @@ class NLSWIN_API_PRIVATE W32EventListener : public virtual EventListener {
     */
    virtual void ProcessGenericEvent(MSG event) = 0;
 
+   virtual ~W32EventListener();
+
    protected:
    /*!
     * @brief Push a new processed platform-independent event onto this listener's queue of events.
@@ -37,8 +49,47 @@ class NLSWIN_API_PRIVATE W32EventListener : public virtual EventListener {
     * @param event The event to push.
     */
    void PushEvent(Event event);
+   /*!
+    * @brief Delivers a translated event to its registered callback, or otherwise pushes it onto the queue.
+    *
+    * @param event The event to deliver.
+    */
+   template <typename EventType>
+   void PushEvent(EventType event) {
+      if (!IsEventWanted<EventType>()) {
+         return;
+      }
+      if (const auto &callback = GetEventCallback<EventType>(); callback) {
+         event.timestamp = CurrentTimestamp();
+         RecordEvent(event);
+         TrackInputState(event);
+         LatencyRecorder::GetInstance().RecordCallback(EventIndex<EventType>::value, event.timestamp);
+         callback(event);
+         return;
+      }
+      PushEvent(Event(std::move(event)));
+   }
+   void UpdateEventCallbacks(const std::function<void()> &update) override;
 
    private:
-   std::queue<Event> m_Queue;
+   friend class W32EventBus;
+   std::deque<Event> m_Queue;
+   /*! The limit set with SetEventQueueLimit, or 0 if the queue may grow. */
+   size_t m_queueLimit {0};
+   EventQueuePolicy m_queuePolicy {EventQueuePolicy::GROW};
+   EventQueueCounters m_queueCounters;
+   bool m_coalesceEvents {false};
+   /*! At most one event per coalescible stream, held back until the end of the current poll. */
+   std::vector<Event> m_coalescedEvents;
+   /*! Moves all held back coalesced events into the queue, in the order their streams began. */
+   void FlushCoalescedEvents();
+   /*! Pushes a stamped event onto the queue, applying the queue limit. */
+   void Enqueue(Event &&event);
+   /*! Whether the queue has reached its limit under EventQueuePolicy::BLOCK. */
+   bool IsBlocking() const noexcept;
+   /*! The timestamp of the message currently being dispatched, with the queue time set to now. */
+   EventTimestamp CurrentTimestamp() const;
+   /*! Appends a stamped event to the running EventRecorder recording, if there is one. */
+   void RecordEvent(const Event &event) const;
 };
 }  // namespace NLSWIN
\ No newline at end of file
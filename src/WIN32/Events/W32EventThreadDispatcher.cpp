@@ -125,6 +125,7 @@ LRESULT CALLBACK W32EventThreadDispatcher::DispatchProc(HWND Window, UINT Messag
       case WM_ACTIVATE:
       case WM_EXITSIZEMOVE:
       case WM_ENTERSIZEMOVE:
+      case WM_DISPLAYCHANGE:
       case WM_KILLFOCUS: {
          PostThreadEvent(Window, Message, WParam, LParam);
          break;
@@ -30,7 +30,7 @@ W32BaseMouse::W32BaseMouse() {
    }
 }
 
-Event W32BaseMouse::PackageRawDeltaEvent(RAWMOUSE mouse) {
+RawMouseDeltaMovementEvent W32BaseMouse::PackageRawDeltaEvent(RAWMOUSE mouse) {
       RawMouseDeltaMovementEvent rawMouseEvent {};
       rawMouseEvent.deltaX = mouse.lLastX;
       rawMouseEvent.deltaY = mouse.lLastY;
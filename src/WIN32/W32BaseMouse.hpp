@@ -13,7 +13,7 @@ class NLSWIN_API_PRIVATE W32BaseMouse {
    W32BaseMouse();
 
    protected:
-   Event PackageRawDeltaEvent(RAWMOUSE mouse);
+   RawMouseDeltaMovementEvent PackageRawDeltaEvent(RAWMOUSE mouse);
 
    private:
    static bool s_firstInit;
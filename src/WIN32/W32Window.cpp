@@ -1,5 +1,10 @@
 #include "W32Window.hpp"
 
+#include <algorithm>
+#include <cmath>
+
+#include "../Common/VideoModeOrder.hpp"
+#include "../Common/VisibilityRequest.hpp"
 #include "Events/W32EventBus.hpp"
 #include "Events/W32EventThreadDispatcher.hpp"
 #include "NamelessWindow/Exceptions.hpp"
@@ -105,6 +110,7 @@ W32Window::W32Window(WindowProperties properties) {
 }
 
 W32Window::~W32Window() {
+   RestoreVideoMode();
    SendMessageW(W32EventThreadDispatcher::GetDispatcherHandle(), DESTROY_NLSWIN_WINDOW,
                 (WPARAM)m_windowHandle, 0);
    m_handleMap.erase(m_windowHandle);
@@ -130,6 +136,17 @@ void W32Window::Hide() {
    ShowWindow(m_windowHandle, SW_HIDE);
 }
 
+std::shared_future<void> W32Window::ShowAsync() {
+   // ShowWindow has finished showing the window by the time it returns.
+   Show();
+   return VisibilityRequest::Completed();
+}
+
+std::shared_future<void> W32Window::HideAsync() {
+   Hide();
+   return VisibilityRequest::Completed();
+}
+
 void W32Window::UpdateWindowData() {
    SetWindowPos(m_windowHandle, 0, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_FRAMECHANGED);
 }
@@ -197,6 +214,7 @@ void W32Window::SetWindowed() noexcept {
 
    // Revert display settings to those stored in registry.
    ChangeDisplaySettingsW(nullptr, 0);
+   m_videoModeChanged = false;
 
    // Restore window decorations, if needed.
    if (!m_borderless) {
@@ -243,7 +261,7 @@ void W32Window::Reposition(uint32_t newX, uint32_t newY) noexcept {
    UpdateRectProperties();
 }
 
-void W32Window::SetNewVideoMode(int width, int height, int bitsPerPixel) {
+void W32Window::SetNewVideoMode(int width, int height, int bitsPerPixel, int refreshRate) {
    // Get the monitor name we should change the video mode for.
    HMONITOR monitor = MonitorFromWindow(m_windowHandle, MONITOR_DEFAULTTONEAREST);
    MONITORINFO info;
@@ -259,6 +277,10 @@ void W32Window::SetNewVideoMode(int width, int height, int bitsPerPixel) {
    mode.dmPelsHeight = height;
    mode.dmBitsPerPel = bitsPerPixel;
    mode.dmFields = DM_BITSPERPEL | DM_PELSWIDTH | DM_PELSHEIGHT;
+   if (refreshRate > 0) {
+      mode.dmDisplayFrequency = refreshRate;
+      mode.dmFields |= DM_DISPLAYFREQUENCY;
+   }
    int returnCode =
       ChangeDisplaySettingsEx(infoWithName.szDevice, &mode, nullptr, CDS_TEST | CDS_FULLSCREEN, nullptr);
    if (returnCode != DISP_CHANGE_SUCCESSFUL) {
@@ -285,6 +307,20 @@ void W32Window::Resize(uint32_t width, uint32_t height) {
    UpdateRectProperties();
 }
 
+void W32Window::SetVideoMode(const VideoMode &mode) {
+   // CDS_FULLSCREEN changes are temporary, so the mode in the registry is the one to restore.
+   SetNewVideoMode(mode.horzResolution, mode.vertResolution, 32,
+                   static_cast<int>(std::lround(mode.refreshRate)));
+   m_videoModeChanged = true;
+}
+
+void W32Window::RestoreVideoMode() {
+   if (m_videoModeChanged) {
+      ChangeDisplaySettingsW(nullptr, 0);
+      m_videoModeChanged = false;
+   }
+}
+
 void W32Window::Focus() noexcept {
    // SetFocus has to be called on the thread that the window was created on.
    // So we must pass this message to our message thread.
@@ -347,6 +383,11 @@ void W32Window::ProcessGenericEvent(MSG event) {
             }
             break;
          }
+         case WM_DISPLAYCHANGE: {
+            // Sent to every top-level window, so each one reports the change once.
+            PushEvent(MonitorsChangedEvent {GetGenericID()});
+            break;
+         }
          case WM_SYSCOMMAND: {
             if (wParam->sourceWindow == m_windowHandle) {
                 if (wParam->wParam == SC_MINIMIZE) {
@@ -369,7 +410,25 @@ static BOOL CALLBACK MonitorEnumerationCallback(HMONITOR monitor, HDC deviceCont
    unsigned int xRes = abs(info.rcMonitor.left - info.rcMonitor.right);
    unsigned int yRes = abs(info.rcMonitor.top - info.rcMonitor.bottom);
 
-   MonitorInfo monitorInfo {xRes, yRes, info.rcMonitor.left, info.rcMonitor.top, info.szDevice};
+   // The same resolution and refresh rate is listed once per color depth and scaling option, so only the
+   // first 32 bit entry, the depth SetVideoMode() switches to, is kept.
+   std::vector<SortableMode> sortableModes;
+   DEVMODE devMode {};
+   devMode.dmSize = sizeof(devMode);
+   for (DWORD i = 0; EnumDisplaySettings(info.szDevice, i, &devMode); i++) {
+      SortableMode mode {static_cast<int>(devMode.dmPelsWidth), static_cast<int>(devMode.dmPelsHeight),
+                         static_cast<float>(devMode.dmDisplayFrequency), i};
+      auto isSameMode = [&mode](const SortableMode &other) {
+         return !ModeOrder(mode, other) && !ModeOrder(other, mode);
+      };
+      if (devMode.dmBitsPerPel == 32 &&
+          std::none_of(sortableModes.begin(), sortableModes.end(), isSameMode)) {
+         sortableModes.push_back(mode);
+      }
+   }
+   std::vector<VideoMode> modes = SortVideoModes(std::move(sortableModes));
+
+   MonitorInfo monitorInfo {xRes, yRes, info.rcMonitor.left, info.rcMonitor.top, info.szDevice, modes};
    monitors->push_back(monitorInfo);
    // Keep enumerating until there's nothing left.
    return true;
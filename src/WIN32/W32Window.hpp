@@ -14,6 +14,7 @@
 #include <windows.h>
 #include <WinUser.h>
 // clang-format on
+#include <future>
 #include <unordered_map>
 
 #include "Events/W32EventListener.hpp"
@@ -38,10 +39,14 @@ class NLSWIN_API_PRIVATE W32Window : public Window, public W32EventListener {
    ~W32Window();
    void Show() override;
    void Hide() override;
+   std::shared_future<void> ShowAsync() override;
+   std::shared_future<void> HideAsync() override;
    void SetFullscreen() override;
    void SetWindowed() noexcept override;
    void Reposition(uint32_t newX, uint32_t newY) noexcept override;
    void Resize(uint32_t width, uint32_t height) override;
+   void SetVideoMode(const VideoMode &mode) override;
+   void RestoreVideoMode() override;
    void Focus() noexcept override;
    void EnableBorderless() noexcept override;
    void DisableBorderless() noexcept override;
@@ -60,7 +65,7 @@ class NLSWIN_API_PRIVATE W32Window : public Window, public W32EventListener {
    [[nodiscard]] static inline WindowID IDFromHWND(HWND handle) { return m_handleMap.at(handle); }
 
    private:
-   void SetNewVideoMode(int width, int height, int bitsPerPixel);
+   void SetNewVideoMode(int width, int height, int bitsPerPixel, int refreshRate = 0);
    void UpdateRectProperties();
    void UpdateWindowData();
    std::pair<long, long> GetWindowSizeFromClientSize(int width, int height);
@@ -72,6 +77,8 @@ class NLSWIN_API_PRIVATE W32Window : public Window, public W32EventListener {
    bool m_shouldClose {false};
    bool m_borderless {false};
    bool m_minimized {false};
+   /*! Whether SetVideoMode has changed the display settings since they were last restored. */
+   bool m_videoModeChanged {false};
 
    std::wstring m_winClassName = L"NLSWINCLASS";
    HWND m_windowHandle {nullptr};
@@ -17,25 +17,13 @@ std::unique_ptr<GLContext> GLContext::Create(const std::shared_ptr<const Window>
 X11GLContext::X11GLContext(std::weak_ptr<const X11Window> window) {
    m_xcbWindow = window;
    auto windowSharedPtr = m_xcbWindow.lock();
-   // Get GLXFBConfig matching the one used by this window
-   int numItems = 0;
-   GLXFBConfig* configs = glXChooseFBConfig(XConnection::GetDisplay(), UTIL::GetDefaultScreenNumber(),
-                                            windowSharedPtr->GetVisualAttributes().data(), &numItems);
-   // Find the returned FBConfig that matches the visual used by this window.
-   for (int i = 0; i < numItems; i++) {
-      int id = 0;
-      glXGetFBConfigAttrib(XConnection::GetDisplay(), configs[i], GLX_VISUAL_ID, &id);
-      auto bab = windowSharedPtr->GetSelectedVisualID();
-      if (id == windowSharedPtr->GetSelectedVisualID()) {
-         m_chosenConfig = configs[i];
-         break;
-      }
-   }
+   // Use the GLXFBConfig the window chose its visual from, rather than searching for it again.
+   m_chosenConfig = windowSharedPtr->GetSelectedFBConfig();
    if (!m_chosenConfig) {
       throw RenderContextInitFailureException();
    }
 
-   m_context = glXCreateNewContext(XConnection::GetDisplay(), configs[0], GLX_RGBA_TYPE, nullptr, true);
+   m_context = glXCreateNewContext(XConnection::GetDisplay(), m_chosenConfig, GLX_RGBA_TYPE, nullptr, true);
    if (!m_context) {
       throw RenderContextInitFailureException();
    }
@@ -12,8 +12,7 @@
 using namespace NLSWIN;
 
 std::shared_ptr<NLSWIN::Cursor> NLSWIN::Cursor::Create() {
-   std::shared_ptr<X11Cursor> impl = std::make_shared<X11Cursor>();
-   X11EventBus::GetInstance().RegisterListener(impl);
+   std::shared_ptr<X11Cursor> impl = X11EventBus::GetInstance().CreateListener<X11Cursor>();
    return std::move(impl);
 }
 
@@ -23,9 +22,46 @@ X11Cursor::X11Cursor() {
       throw MultipleCursorException();
    }
    m_deviceID = GetMasterPointerDeviceID();
+   // Both cursor and raw motion arrive at the polling rate of every connected mouse.
+   ConfigureQueue(1024, QueueOverflowPolicy::GROW);
    xcb_pixmap_t pixmap = xcb_generate_id(XConnection::GetConnection());
    xcb_create_cursor(XConnection::GetConnection(), m_cursor, pixmap, pixmap, 0, 0, 0, 0, 0, 0, 0, 0);
-   SubscribeToRawRootEvents(m_rawInputEventMask);
+   SubscribeToRawRootEvents(RawInputEventMask());
+   // The cursor receives core pointer events from every application window, as well as the window it is
+   // confined to.
+   for (auto eventType: {XCB_BUTTON_PRESS, XCB_BUTTON_RELEASE, XCB_ENTER_NOTIFY, XCB_LEAVE_NOTIFY,
+                         XCB_FOCUS_OUT, XCB_FOCUS_IN, XCB_MOTION_NOTIFY, XCB_DESTROY_NOTIFY}) {
+      ListenFor(X11EventRoute::Core(eventType));
+   }
+}
+
+xcb_event_mask_t X11Cursor::PointerEventMask() const noexcept {
+   uint32_t mask = XCB_EVENT_MASK_ENTER_WINDOW | XCB_EVENT_MASK_LEAVE_WINDOW | XCB_EVENT_MASK_FOCUS_CHANGE;
+   if (IsEventWanted<MouseButtonEvent>() || IsEventWanted<MouseScrollEvent>()) {
+      mask |= XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE;
+   }
+   if (IsEventWanted<MouseMovementEvent>()) {
+      mask |= XCB_EVENT_MASK_POINTER_MOTION;
+   }
+   return (xcb_event_mask_t)mask;
+}
+
+xcb_input_xi_event_mask_t X11Cursor::RawInputEventMask() const noexcept {
+   uint32_t mask = XCB_INPUT_XI_EVENT_MASK_ENTER;
+   if (IsEventWanted<RawMouseDeltaMovementEvent>()) {
+      mask |= XCB_INPUT_XI_EVENT_MASK_RAW_MOTION;
+   }
+   return (xcb_input_xi_event_mask_t)mask;
+}
+
+void X11Cursor::OnEventFilterChanged() {
+   SubscribeToRawRootEvents(RawInputEventMask());
+   X11Window::SetPointerEventMask(PointerEventMask());
+   if (m_boundWindow && !m_isTempUnbound) {
+      xcb_change_active_pointer_grab(XConnection::GetConnection(), m_cursor, XCB_CURRENT_TIME,
+                                     PointerEventMask());
+      xcb_flush(XConnection::GetConnection());
+   }
 }
 
 void X11Cursor::Show() noexcept {
@@ -110,9 +146,9 @@ void X11Cursor::ProcessGenericEvent(xcb_generic_event_t *event) {
       case XCB_FOCUS_IN: {
          xcb_focus_in_event_t *focusInEvent = reinterpret_cast<xcb_focus_in_event_t *>(event);
          if (focusInEvent->event == m_boundWindow && m_isTempUnbound) {
-            auto cookie = xcb_grab_pointer(XConnection::GetConnection(), false, m_boundWindow, m_xcbEventMask,
-                                           XCB_GRAB_MODE_ASYNC, XCB_GRAB_MODE_ASYNC, m_boundWindow, m_cursor,
-                                           XCB_CURRENT_TIME);
+            auto cookie = xcb_grab_pointer(XConnection::GetConnection(), false, m_boundWindow,
+                                           PointerEventMask(), XCB_GRAB_MODE_ASYNC, XCB_GRAB_MODE_ASYNC,
+                                           m_boundWindow, m_cursor, XCB_CURRENT_TIME);
             xcb_flush(XConnection::GetConnection());
             m_isTempUnbound = false;
          }
@@ -120,7 +156,9 @@ void X11Cursor::ProcessGenericEvent(xcb_generic_event_t *event) {
       }
       case XCB_MOTION_NOTIFY: {
          xcb_motion_notify_event_t *motionEvent = reinterpret_cast<xcb_motion_notify_event_t *>(event);
-         PushEvent(PackageNewMoveEvent(motionEvent, motionEvent->event));
+         if (auto moveEvent = PackageNewMoveEvent(motionEvent, motionEvent->event)) {
+            PushEvent(*moveEvent);
+         }
          break;
       }
       case XCB_DESTROY_NOTIFY: {
@@ -144,7 +182,9 @@ void X11Cursor::ProcessGenericEvent(xcb_generic_event_t *event) {
                   break;
                }
                lastTimeStamp = rawEvent->time;
-               PushEvent(PackageNewDeltaEvents(rawEvent));
+               if (auto deltaEvent = PackageNewDeltaEvents(rawEvent)) {
+                  PushEvent(*deltaEvent);
+               }
                break;
             }
          }
@@ -163,9 +203,9 @@ void X11Cursor::Confine(Window *window) noexcept {
    const X11Window *const x11Window = reinterpret_cast<const X11Window *const>(window);
    // Always unbind the cursor first
    Free();
-   auto cookie = xcb_grab_pointer(XConnection::GetConnection(), false, x11Window->GetX11ID(), m_xcbEventMask,
-                                  XCB_GRAB_MODE_ASYNC, XCB_GRAB_MODE_ASYNC, x11Window->GetX11ID(), m_cursor,
-                                  XCB_CURRENT_TIME);
+   auto cookie = xcb_grab_pointer(XConnection::GetConnection(), false, x11Window->GetX11ID(),
+                                  PointerEventMask(), XCB_GRAB_MODE_ASYNC, XCB_GRAB_MODE_ASYNC,
+                                  x11Window->GetX11ID(), m_cursor, XCB_CURRENT_TIME);
 
    m_boundWindow = x11Window->GetX11ID();
    xcb_flush(XConnection::GetConnection());
@@ -202,13 +242,14 @@ Event X11Cursor::PackageNewButtonReleaseEvent(xcb_button_press_event_t *event, x
    return mouseButtonEvent;
 }
 
-Event X11Cursor::PackageNewMoveEvent(xcb_motion_notify_event_t *event, xcb_window_t sourceWindow) {
+std::optional<MouseMovementEvent> X11Cursor::PackageNewMoveEvent(xcb_motion_notify_event_t *event,
+                                                                 xcb_window_t sourceWindow) {
    float newX = event->event_x;
    float newY = event->event_y;
    // Don't send an event if we've somehow recieved a motion event yet we havent moved.
    // (for example, when using the scroll wheel ??)
    if (newX == lastX && newY == lastY) {
-      return std::monostate();
+      return std::nullopt;
    }
    MouseMovementEvent moveEvent;
    moveEvent.newXPos = newX;
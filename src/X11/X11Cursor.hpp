@@ -9,6 +9,8 @@
  */
 #pragma once
 
+#include <optional>
+
 #include "NamelessWindow/Cursor.hpp"
 #include "NamelessWindow/NLSAPI.hpp"
 #include "NamelessWindow/Window.hpp"
@@ -29,6 +31,7 @@ class NLSWIN_API_PRIVATE X11Cursor : public X11GenericMouse, public X11InputDevi
 
    protected:
    void ProcessGenericEvent(xcb_generic_event_t *event) override;
+   void OnEventFilterChanged() override;
    /*! @brief Attempts to inform the X server to make the cursor icon visible when the cursor is within bounds
     * of a subscribed window, if certain conditions are met.
     */
@@ -39,7 +42,8 @@ class NLSWIN_API_PRIVATE X11Cursor : public X11GenericMouse, public X11InputDevi
    void AttemptSetHidden();
    Event PackageNewButtonPressEvent(xcb_button_press_event_t *event, xcb_window_t sourceWindow);
    Event PackageNewButtonReleaseEvent(xcb_button_release_event_t *event, xcb_window_t sourceWindow);
-   Event PackageNewMoveEvent(xcb_motion_notify_event_t *motionEvent, xcb_window_t sourceWindow);
+   std::optional<MouseMovementEvent> PackageNewMoveEvent(xcb_motion_notify_event_t *motionEvent,
+                                                         xcb_window_t sourceWindow);
 
    private:
    xcb_cursor_t m_cursor;
@@ -50,19 +54,21 @@ class NLSWIN_API_PRIVATE X11Cursor : public X11GenericMouse, public X11InputDevi
    float lastX {0};
    float lastY {0};
    /*! The X11 window that the cursor is currently bound to, or 0. */
-   xcb_window_t m_boundWindow;
+   xcb_window_t m_boundWindow {0};
    bool m_isTempUnbound {false};
    /*! The X11 window the cursor is currently inside. Value is 0 when not within a window that has been
     * subscribed to. */
    xcb_window_t m_inhabitedWindow;
    /*! @todo Will need to update this if we support multiple cursors. Right now it only expects one. */
    static xcb_input_device_id_t GetMasterPointerDeviceID() noexcept;
-   const xcb_event_mask_t m_xcbEventMask {
-      (xcb_event_mask_t)(XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE |
-                         XCB_EVENT_MASK_POINTER_MOTION | XCB_EVENT_MASK_ENTER_WINDOW |
-                         XCB_EVENT_MASK_LEAVE_WINDOW | XCB_EVENT_MASK_FOCUS_CHANGE)};
-   const xcb_input_xi_event_mask_t m_rawInputEventMask {
-      (xcb_input_xi_event_mask_t)(XCB_INPUT_XI_EVENT_MASK_RAW_MOTION | XCB_INPUT_XI_EVENT_MASK_ENTER)};
+   /*!
+    * The core pointer events to select on application windows and to grab the pointer with. Crossing and
+    * focus events are always selected, as they are needed to hide and confine the cursor; button and motion
+    * events only when the event filter lets through the events they generate.
+    */
+   [[nodiscard]] xcb_event_mask_t PointerEventMask() const noexcept;
+   /*! The raw XI2 events to select on the root window. */
+   [[nodiscard]] xcb_input_xi_event_mask_t RawInputEventMask() const noexcept;
 };
 
 }  // namespace NLSWIN
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "X11EventArena.hpp"
+
+#include <cstring>
+
+using namespace NLSWIN;
+
+size_t X11EventArena::SizeOf(const xcb_generic_event_t *event) noexcept {
+   // libxcb appends the full_sequence field to every event, and places any extra data of XGE events after it.
+   if ((event->response_type & ~0x80) == XCB_GE_GENERIC) {
+      auto genericEvent = reinterpret_cast<const xcb_ge_generic_event_t *>(event);
+      return sizeof(xcb_generic_event_t) + genericEvent->length * 4;
+   }
+   return sizeof(xcb_generic_event_t);
+}
+
+xcb_generic_event_t *X11EventArena::Store(const xcb_generic_event_t *event) {
+   size_t size = SizeOf(event);
+   if (size > SLOT_SIZE) {
+      return nullptr;
+   }
+   size_t block = m_usedSlots / SLOTS_PER_BLOCK;
+   if (block == m_blocks.size()) {
+      m_blocks.emplace_back(new Slot[SLOTS_PER_BLOCK]);
+   }
+   Slot &slot = m_blocks[block][m_usedSlots % SLOTS_PER_BLOCK];
+   m_usedSlots++;
+   std::memcpy(slot.bytes, event, size);
+   return reinterpret_cast<xcb_generic_event_t *>(slot.bytes);
+}
@@ -0,0 +1,59 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @addtogroup X11 Linux X11 API
+ * @brief Platform-specific X11 implementation of the API
+ */
+#pragma once
+
+#include <xcb/xcb.h>
+
+#include <memory>
+#include <vector>
+
+#include "NamelessWindow/NLSAPI.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief Reusable storage for the X events polled during a single call to X11EventBus::PollEvents.
+ * @ingroup X11
+ *
+ * libxcb allocates every event it returns. Rather than holding on to those allocations until the next poll,
+ * the bus copies each event into a fixed-size slot of this arena and frees the libxcb buffer immediately.
+ * Slots are handed out from blocks that are never released, so once the arena has grown to the largest
+ * number of events seen in a single poll, storing events no longer allocates.
+ */
+class NLSWIN_API_PRIVATE X11EventArena {
+   public:
+   /*! Large enough for any core event, and XI2 events carrying a generous number of valuators. */
+   static constexpr size_t SLOT_SIZE = 512;
+   static constexpr size_t SLOTS_PER_BLOCK = 64;
+
+   /*!
+    * @brief Copies an event into the next free slot of the arena.
+    *
+    * @param event The event to copy. Ownership is not taken.
+    * @return The copy of the event, or nullptr if the event is too large to fit in a slot.
+    */
+   [[nodiscard]] xcb_generic_event_t *Store(const xcb_generic_event_t *event);
+   /*!
+    * @brief Makes every slot available for reuse.
+    * @post All events previously returned by Store are invalidated.
+    */
+   void Reset() noexcept { m_usedSlots = 0; }
+   /*! Gets the size in bytes of an event as it was allocated by libxcb. */
+   [[nodiscard]] static size_t SizeOf(const xcb_generic_event_t *event) noexcept;
+
+   private:
+   struct alignas(8) Slot {
+      uint8_t bytes[SLOT_SIZE];
+   };
+   std::vector<std::unique_ptr<Slot[]>> m_blocks;
+   size_t m_usedSlots {0};
+};
+
+}  // namespace NLSWIN
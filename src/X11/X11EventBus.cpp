@@ -1,29 +1,615 @@
 #include "X11EventBus.hpp"
 
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
 #include <xcb/xcb.h>
+#include <xcb/xinput.h>
+#define explicit explicit_
+#include <xcb/xkb.h>
+#undef explicit
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+
+#include "../Common/ClockCalibrator.hpp"
+#include "NamelessWindow/Exceptions.hpp"
+#include "X11MonitorCache.hpp"
 #include "XConnection.h"
 
 using namespace NLSWIN;
 
-void X11EventBus::PollEvents() {
-   // xcb events are dynamically allocated, so to avoid memory leaks we must free all events from the last
-   // poll.
+/*!
+ * @brief Determines the route an X event travels along: its type, the window it targets and the device it
+ * originated from.
+ */
+static X11EventRoute RouteOf(xcb_generic_event_t *event) {
+   uint8_t type = event->response_type & ~0x80;
+   switch (type) {
+      case XCB_KEY_PRESS:
+      case XCB_KEY_RELEASE:
+      case XCB_BUTTON_PRESS:
+      case XCB_BUTTON_RELEASE:
+      case XCB_MOTION_NOTIFY:
+         return X11EventRoute::Core(type, reinterpret_cast<xcb_key_press_event_t *>(event)->event);
+      case XCB_ENTER_NOTIFY:
+      case XCB_LEAVE_NOTIFY:
+         return X11EventRoute::Core(type, reinterpret_cast<xcb_enter_notify_event_t *>(event)->event);
+      case XCB_FOCUS_IN:
+      case XCB_FOCUS_OUT:
+         return X11EventRoute::Core(type, reinterpret_cast<xcb_focus_in_event_t *>(event)->event);
+      case XCB_CONFIGURE_NOTIFY:
+         return X11EventRoute::Core(type, reinterpret_cast<xcb_configure_notify_event_t *>(event)->event);
+      case XCB_MAP_NOTIFY:
+         return X11EventRoute::Core(type, reinterpret_cast<xcb_map_notify_event_t *>(event)->event);
+      case XCB_UNMAP_NOTIFY:
+         return X11EventRoute::Core(type, reinterpret_cast<xcb_unmap_notify_event_t *>(event)->event);
+      case XCB_DESTROY_NOTIFY:
+         return X11EventRoute::Core(type, reinterpret_cast<xcb_destroy_notify_event_t *>(event)->event);
+      case XCB_REPARENT_NOTIFY:
+         return X11EventRoute::Core(type, reinterpret_cast<xcb_reparent_notify_event_t *>(event)->event);
+      case XCB_PROPERTY_NOTIFY:
+         return X11EventRoute::Core(type, reinterpret_cast<xcb_property_notify_event_t *>(event)->window);
+      case XCB_CLIENT_MESSAGE:
+         return X11EventRoute::Core(type, reinterpret_cast<xcb_client_message_event_t *>(event)->window);
+      case XCB_VISIBILITY_NOTIFY:
+         return X11EventRoute::Core(type, reinterpret_cast<xcb_visibility_notify_event_t *>(event)->window);
+      case XCB_GE_GENERIC: {
+         // All XI2 device events share the same header layout up to and including the device ID.
+         auto deviceEvent = reinterpret_cast<xcb_input_key_press_event_t *>(event);
+         switch (deviceEvent->event_type) {
+            case XCB_INPUT_KEY_PRESS:
+            case XCB_INPUT_KEY_RELEASE:
+            case XCB_INPUT_BUTTON_PRESS:
+            case XCB_INPUT_BUTTON_RELEASE:
+            case XCB_INPUT_MOTION:
+               return X11EventRoute::XI2(deviceEvent->event_type, deviceEvent->event, deviceEvent->deviceid);
+            case XCB_INPUT_ENTER:
+            case XCB_INPUT_LEAVE:
+            case XCB_INPUT_FOCUS_IN:
+            case XCB_INPUT_FOCUS_OUT: {
+               auto enterEvent = reinterpret_cast<xcb_input_enter_event_t *>(event);
+               return X11EventRoute::XI2(enterEvent->event_type, enterEvent->event, enterEvent->deviceid);
+            }
+            default:
+               // Raw events are only ever selected on the root window, so only the device matters.
+               return X11EventRoute::XI2(deviceEvent->event_type, 0, deviceEvent->deviceid);
+         }
+      }
+      default: {
+         if (type == XConnection::GetXKBBaseEvent()) {
+            // All XKB events share the same header layout up to and including the device ID.
+            auto xkbEvent = reinterpret_cast<xcb_xkb_state_notify_event_t *>(event);
+            return {type, 0, xkbEvent->deviceID};
+         }
+         return X11EventRoute::Core(type);
+      }
+   }
+}
+
+/*! @brief The server time at which an event was generated, or 0 for events that do not carry one. */
+static xcb_timestamp_t TimeOf(xcb_generic_event_t *event) {
+   uint8_t type = event->response_type & ~0x80;
+   switch (type) {
+      case XCB_KEY_PRESS:
+      case XCB_KEY_RELEASE:
+      case XCB_BUTTON_PRESS:
+      case XCB_BUTTON_RELEASE:
+      case XCB_MOTION_NOTIFY:
+         return reinterpret_cast<xcb_key_press_event_t *>(event)->time;
+      case XCB_ENTER_NOTIFY:
+      case XCB_LEAVE_NOTIFY:
+         return reinterpret_cast<xcb_enter_notify_event_t *>(event)->time;
+      case XCB_PROPERTY_NOTIFY:
+         return reinterpret_cast<xcb_property_notify_event_t *>(event)->time;
+      case XCB_GE_GENERIC:
+         // XI2 events, including raw events, share the same header layout up to and including the time.
+         return reinterpret_cast<xcb_input_key_press_event_t *>(event)->time;
+      default:
+         if (type == XConnection::GetXKBBaseEvent()) {
+            return reinterpret_cast<xcb_xkb_state_notify_event_t *>(event)->time;
+         }
+         return 0;
+   }
+}
+
+X11EventBus::X11EventBus() {
+   m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+   if (m_wakeFd < 0) {
+      throw PlatformInitializationException();
+   }
+}
+
+X11EventBus::~X11EventBus() {
+   if (m_inputThread.joinable()) {
+      // Only reached during static destruction, when the connection and the listeners may already be gone, so
+      // the input thread is woken by shutting down the socket underneath libxcb rather than with a request.
+      m_stopInputThread = true;
+      shutdown(m_inputThreadSocket, SHUT_RDWR);
+      m_inputThread.join();
+   }
    FreeOldEvents();
-   xcb_generic_event_t *event = nullptr;
-   while (event = xcb_poll_for_event(XConnection::GetConnection())) {
+   for (const auto &deferred: m_deferredEvents) { free(deferred.event); }
+   close(m_wakeFd);
+}
+
+/*! Counts a poll as in progress for as long as it is in scope, however the poll is left. */
+class DispatchDepthGuard {
+   public:
+   explicit DispatchDepthGuard(unsigned int &depth) : m_depth(depth) { m_depth++; }
+   ~DispatchDepthGuard() { m_depth--; }
+   DispatchDepthGuard(const DispatchDepthGuard &) = delete;
+   void operator=(const DispatchDepthGuard &) = delete;
+
+   private:
+   unsigned int &m_depth;
+};
+
+void X11EventBus::BeginPoll() {
+   // Events from the last poll are no longer needed, so their storage can be recycled.
+   FreeOldEvents();
+   m_eventArena.Reset();
+   if (m_staleRouteCount >= STALE_ROUTE_SWEEP_THRESHOLD) {
+      PruneStaleRoutes();
+   }
+}
+
+void X11EventBus::StoreAndDispatch(xcb_generic_event_t *event) {
+   m_captureTime = std::chrono::steady_clock::now();
+   xcb_generic_event_t *storedEvent = m_eventArena.Store(event);
+   if (storedEvent) {
+      free(event);
+   } else {
+      // Too large for the arena, so keep the libxcb allocation around until the next poll instead.
+      storedEvent = event;
       m_eventsToFreeNextPoll.push_back(event);
-      for (auto iter = m_listeners.begin(); iter != m_listeners.end();) {
-         if (!(*iter).expired()) {
-            auto listenerSharedPtr = (*iter).lock();
-            listenerSharedPtr->ProcessGenericEvent(event);
-            iter++;
+   }
+   Dispatch(storedEvent, DispatchTarget::ALL);
+}
+
+void X11EventBus::PollEvents() {
+   DispatchPendingEvents(nullptr);
+}
+
+void X11EventBus::DispatchPendingEvents(xcb_generic_event_t *queuedEvent) {
+   std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+   bool connectionFailed = m_inputThreadExited && !m_stopInputThread && m_inputThread.joinable();
+   if (connectionFailed) {
+      ReapInputThread();
+   }
+   DispatchDepthGuard depth(m_dispatchDepth);
+   // A listener may poll again from a callback, in which case the outer poll is still using its events.
+   bool isOutermost = m_dispatchDepth == 1;
+   if (isOutermost) {
+      BeginPoll();
+   }
+   ReleaseHeldBackEvents();
+   // Input devices have already received these events on the input thread. A nested poll only takes the
+   // events deferred since the outer poll took its own, and so cannot reuse its storage.
+   std::vector<DeferredEvent> dispatching;
+   if (isOutermost) {
+      dispatching.swap(m_dispatchingEvents);
+   }
+   dispatching.swap(m_deferredEvents);
+   size_t dispatched = 0;
+   // If a listener throws, anything left is dispatched by a later poll.
+   auto deferRemaining = [this, &dispatching, &dispatched]() {
+      m_deferredEvents.insert(m_deferredEvents.begin(), dispatching.begin() + dispatched, dispatching.end());
+   };
+   try {
+      for (; dispatched < dispatching.size(); dispatched++) {
+         // Freed by the next poll, the same as the events it reads from the connection.
+         m_eventsToFreeNextPoll.push_back(dispatching[dispatched].event);
+         m_captureTime = dispatching[dispatched].captureTime;
+         Dispatch(dispatching[dispatched].event, dispatching[dispatched].target);
+      }
+   } catch (...) {
+      dispatched++;
+      deferRemaining();
+      throw;
+   }
+   deferRemaining();
+   if (isOutermost) {
+      dispatching.clear();
+      m_dispatchingEvents.swap(dispatching);
+   }
+   if (queuedEvent) {
+      StoreAndDispatch(queuedEvent);
+   }
+   // While the input thread is running, it is the only reader of the connection.
+   if (!m_inputThread.joinable()) {
+      DrainConnection();
+   }
+   FlushCoalescedEvents();
+   if (connectionFailed) {
+      throw PlatformInitializationException();
+   }
+}
+
+void X11EventBus::DrainConnection() {
+   xcb_connection_t *connection = XConnection::GetConnection();
+   size_t remaining = m_pollBudgetEvents != 0 ? m_pollBudgetEvents : std::numeric_limits<size_t>::max();
+   auto deadline = std::chrono::steady_clock::time_point::max();
+   if (m_pollBudgetTime.count() != 0) {
+      deadline = std::chrono::steady_clock::now() + m_pollBudgetTime;
+   }
+   // xcb_poll_for_event only reads from the socket if libxcb has nothing buffered, and would do so again
+   // every time the buffer runs dry. A single read per poll keeps the number of syscalls per frame constant;
+   // anything that arrives in the meantime is picked up by the next poll.
+   xcb_generic_event_t *event = xcb_poll_for_event(connection);
+   while (event) {
+      StoreAndDispatch(event);
+      // StoreAndDispatch has just sampled the clock, as the event's capture time.
+      if (--remaining == 0 || m_captureTime >= deadline) {
+         break;
+      }
+      event = xcb_poll_for_queued_event(connection);
+   }
+}
+
+void X11EventBus::SetPollBudget(size_t maxEvents, std::chrono::microseconds maxTime) {
+   std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+   m_pollBudgetEvents = maxEvents;
+   m_pollBudgetTime = std::max(maxTime, std::chrono::microseconds(0));
+}
+
+void X11EventBus::WaitEvents(int timeoutMilliseconds) {
+   xcb_connection_t *connection = XConnection::GetConnection();
+   // Requests still sitting in libxcb's output buffer may be what the server needs to generate the events
+   // we are about to wait for.
+   xcb_flush(connection);
+   xcb_generic_event_t *queuedEvent = nullptr;
+   bool hasPendingEvents = false;
+   {
+      std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+      // Held back events that now fit into a queue the application has drained are as good as new ones.
+      hasPendingEvents = ReleaseHeldBackEvents() || (m_inputThread.joinable() && !m_deferredEvents.empty());
+   }
+   if (m_inputThread.joinable()) {
+      // The input thread wakes us up whenever it has handed off a batch of events, and as it exits.
+      if (!hasPendingEvents && !m_inputThreadExited) {
+         WaitForActivity(false, timeoutMilliseconds);
+      }
+   } else if (!hasPendingEvents && !(queuedEvent = xcb_poll_for_queued_event(connection))) {
+      // libxcb may have already read events off the socket while waiting on a reply, in which case the socket
+      // will not become readable again until the server sends something else. Only wait if it has not.
+      WaitForActivity(true, timeoutMilliseconds);
+   }
+   DispatchPendingEvents(queuedEvent);
+}
+
+bool X11EventBus::WaitForEvent(const std::function<bool(const xcb_generic_event_t *)> &isAwaited,
+                               int timeoutMilliseconds) {
+   xcb_connection_t *connection = XConnection::GetConnection();
+   // The awaited event may be the response to a request still sitting in libxcb's output buffer.
+   xcb_flush(connection);
+   auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMilliseconds);
+   while (true) {
+      {
+         std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+         if (DispatchAwaitedEvent(isAwaited)) {
+            return true;
+         }
+      }
+      int remaining = -1;
+      if (timeoutMilliseconds >= 0) {
+         auto timeLeft =
+            std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+         if (timeLeft.count() <= 0) {
+            return false;
+         }
+         remaining = static_cast<int>(timeLeft.count());
+      }
+      if (xcb_connection_has_error(connection) || m_inputThreadExited) {
+         return false;
+      }
+      // The input thread wakes us up whenever it has handed off a batch of events.
+      WaitForActivity(!m_inputThread.joinable(), remaining);
+   }
+}
+
+bool X11EventBus::DispatchAwaitedEvent(const std::function<bool(const xcb_generic_event_t *)> &isAwaited) {
+   DeferredEvent awaited;
+   auto deferred =
+      std::find_if(m_deferredEvents.begin(), m_deferredEvents.end(),
+                   [&isAwaited](const DeferredEvent &candidate) { return isAwaited(candidate.event); });
+   if (deferred != m_deferredEvents.end()) {
+      awaited = *deferred;
+      m_deferredEvents.erase(deferred);
+   } else if (!m_inputThread.joinable()) {
+      // Everything read before the awaited event is left, in order, for the next poll to dispatch.
+      while (xcb_generic_event_t *event = xcb_poll_for_event(XConnection::GetConnection())) {
+         DeferredEvent read {event, std::chrono::steady_clock::now(), DispatchTarget::ALL};
+         if (isAwaited(event)) {
+            awaited = read;
+            break;
+         }
+         m_deferredEvents.push_back(read);
+      }
+   }
+   if (!awaited.event) {
+      return false;
+   }
+   // Counted as a poll, so that a poll from one of the listener's callbacks leaves the event alone.
+   DispatchDepthGuard depth(m_dispatchDepth);
+   m_eventsToFreeNextPoll.push_back(awaited.event);
+   m_captureTime = awaited.captureTime;
+   Dispatch(awaited.event, awaited.target);
+   FlushCoalescedEvents();
+   return true;
+}
+
+void X11EventBus::WaitForActivity(bool includeConnection, int timeoutMilliseconds) {
+   // poll() ignores negative file descriptors.
+   int connectionFd = includeConnection ? xcb_get_file_descriptor(XConnection::GetConnection()) : -1;
+   pollfd fds[2] = {{connectionFd, POLLIN, 0}, {m_wakeFd, POLLIN, 0}};
+   auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMilliseconds);
+   int remaining = timeoutMilliseconds;
+   while (poll(fds, 2, remaining) < 0 && errno == EINTR) {
+      // Interrupted by a signal, so resume waiting for whatever is left of the timeout.
+      if (timeoutMilliseconds >= 0) {
+         auto timeLeft = deadline - std::chrono::steady_clock::now();
+         remaining = std::max(0, static_cast<int>(
+                                    std::chrono::duration_cast<std::chrono::milliseconds>(timeLeft).count()));
+      }
+   }
+   if (fds[1].revents & POLLIN) {
+      // Consume the wake-up, so that the next wait does not return immediately.
+      // EAGAIN means that another waiter consumed it first.
+      uint64_t wakeCount = 0;
+      if (read(m_wakeFd, &wakeCount, sizeof(wakeCount)) < 0 && errno != EAGAIN && errno != EINTR) {
+         throw PlatformInitializationException();
+      }
+   }
+}
+
+void X11EventBus::Wake() {
+   if (!SignalWake()) {
+      throw PlatformInitializationException();
+   }
+}
+
+bool X11EventBus::SignalWake() noexcept {
+   uint64_t increment = 1;
+   // EAGAIN means that the counter is saturated, so a wake-up is already pending.
+   return write(m_wakeFd, &increment, sizeof(increment)) >= 0 || errno == EAGAIN || errno == EINTR;
+}
+
+void X11EventBus::StartInputThread() {
+   std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+   if (m_inputThread.joinable()) {
+      return;
+   }
+   for (auto &slot: m_listenerSlots) {
+      if (slot.listener) {
+         PrepareQueueForInputThread(slot.listener);
+      }
+   }
+   // An invisible window, used only as the destination of the message that stops the input thread.
+   xcb_connection_t *connection = XConnection::GetConnection();
+   m_inputThreadWindow = xcb_generate_id(connection);
+   xcb_create_window(connection, XCB_COPY_FROM_PARENT, m_inputThreadWindow, XConnection::GetRootWindow(), 0,
+                     0, 1, 1, 0, XCB_WINDOW_CLASS_INPUT_ONLY, XCB_COPY_FROM_PARENT, 0, nullptr);
+   xcb_flush(connection);
+   m_inputThreadSocket = xcb_get_file_descriptor(connection);
+   m_stopInputThread = false;
+   m_inputThreadExited = false;
+   m_inputThread = std::thread(&X11EventBus::InputThreadMain, this);
+}
+
+void X11EventBus::StopInputThread() {
+   if (!m_inputThread.joinable()) {
+      return;
+   }
+   xcb_connection_t *connection = XConnection::GetConnection();
+   m_stopInputThread = true;
+   // The input thread is blocked inside libxcb, so it can only be woken up by an event.
+   xcb_client_message_event_t stopMessage {};
+   stopMessage.response_type = XCB_CLIENT_MESSAGE;
+   stopMessage.format = 32;
+   stopMessage.window = m_inputThreadWindow;
+   xcb_send_event(connection, false, m_inputThreadWindow, XCB_EVENT_MASK_NO_EVENT,
+                  reinterpret_cast<const char *>(&stopMessage));
+   xcb_flush(connection);
+   m_inputThread.join();
+   xcb_destroy_window(connection, m_inputThreadWindow);
+   xcb_flush(connection);
+   m_inputThreadWindow = 0;
+   std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+   RestoreQueuesAfterInputThread();
+}
+
+void X11EventBus::ReapInputThread() {
+   // The thread has already left its loop, and never takes the dispatch mutex again on its way out.
+   m_inputThread.join();
+   // Nothing more can be sent over a failed connection, so the window is left for the server to clean up.
+   m_inputThreadWindow = 0;
+   RestoreQueuesAfterInputThread();
+}
+
+void X11EventBus::RestoreQueuesAfterInputThread() {
+   for (auto &slot: m_listenerSlots) {
+      X11EventListener *listener = slot.listener;
+      // Only queues that PrepareQueueForInputThread switched, or would have, are allowed to grow.
+      if (listener && listener->m_queuePolicy == EventQueuePolicy::GROW &&
+          listener->m_Queue.GetOverflowPolicy() == QueueOverflowPolicy::DROP_OLDEST) {
+         listener->m_Queue.Configure(listener->m_Queue.Capacity(), QueueOverflowPolicy::GROW);
+      }
+   }
+}
+
+void X11EventBus::InputThreadMain() {
+   xcb_connection_t *connection = XConnection::GetConnection();
+   // Unlike poll() on the socket, xcb_wait_for_event also returns for events that another thread read off the
+   // socket while it was waiting on a reply.
+   while (xcb_generic_event_t *event = WaitForInputThreadEvent()) {
+      {
+         std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+         ReleaseHeldBackEvents();
+         // The wait has just read from the socket, so only drain what that read buffered.
+         do { HandOff(event); } while ((event = xcb_poll_for_queued_event(connection)));
+         FlushCoalescedEvents();
+      }
+      SignalWake();
+      if (m_stopInputThread) {
+         break;
+      }
+   }
+   // Either asked to stop, or the connection has failed, in which case the next poll reports the error.
+   m_inputThreadExited = true;
+   SignalWake();
+}
+
+void X11EventBus::HandOff(xcb_generic_event_t *event) {
+   m_captureTime = std::chrono::steady_clock::now();
+   uint8_t type = event->response_type & ~0x80;
+   bool isStopMessage = type == XCB_CLIENT_MESSAGE &&
+                        reinterpret_cast<xcb_client_message_event_t *>(event)->window == m_inputThreadWindow;
+   // Input devices receive every event they listen for right away, including the cursor's enter, leave and
+   // focus events, so that they are translated in the order they arrived.
+   if (!isStopMessage && Dispatch(event, DispatchTarget::INPUT_DEVICES)) {
+      // Other listeners update state that the application reads from its own thread, so they receive the
+      // event from there during the next poll instead. The event is kept whole, as XI2 events may be larger
+      // than the 32 bytes of a core event.
+      m_deferredEvents.push_back({event, m_captureTime, DispatchTarget::OTHERS});
+      return;
+   }
+   free(event);
+}
+
+xcb_generic_event_t *X11EventBus::WaitForInputThreadEvent() {
+   xcb_connection_t *connection = XConnection::GetConnection();
+   while (!m_stopInputThread) {
+      {
+         std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+         if (m_heldBackListeners.empty()) {
+            break;
+         }
+         if (ReleaseHeldBackEvents()) {
+            SignalWake();
+         }
+      }
+      if (xcb_generic_event_t *event = xcb_poll_for_event(connection)) {
+         return event;
+      }
+      if (xcb_connection_has_error(connection)) {
+         return nullptr;
+      }
+      // The application pops from its queues without taking any lock, so there is nothing to be woken by.
+      std::this_thread::sleep_for(HOLD_BACK_RETRY_INTERVAL);
+   }
+   return xcb_wait_for_event(connection);
+}
+
+void X11EventBus::HoldBack(X11EventListener *listener) {
+   if (std::find(m_heldBackListeners.begin(), m_heldBackListeners.end(), listener) ==
+       m_heldBackListeners.end()) {
+      m_heldBackListeners.push_back(listener);
+   }
+}
+
+bool X11EventBus::ReleaseHeldBackEvents() {
+   bool released = false;
+   m_heldBackListeners.erase(std::remove_if(m_heldBackListeners.begin(), m_heldBackListeners.end(),
+                                            [&released](X11EventListener *listener) {
+                                               size_t heldBack = listener->m_heldBackEvents.size();
+                                               bool isDone = listener->ReleaseHeldBackEvents();
+                                               released |= listener->m_heldBackEvents.size() != heldBack;
+                                               return isDone;
+                                            }),
+                             m_heldBackListeners.end());
+   return released;
+}
+
+void X11EventBus::SetMonitorCache(X11MonitorCache *cache) {
+   std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+   m_monitorCache = cache;
+}
+
+void X11EventBus::ScheduleCoalescedFlush(X11EventListener *listener) {
+   std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+   m_listenersToFlush.push_back(listener);
+}
+
+void X11EventBus::CancelCoalescedFlush(const X11EventListener *listener) {
+   std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+   m_listenersToFlush.erase(std::remove(m_listenersToFlush.begin(), m_listenersToFlush.end(), listener),
+                            m_listenersToFlush.end());
+}
+
+void X11EventBus::FlushCoalescedEvents() {
+   for (auto listener: m_listenersToFlush) {
+      listener->m_coalescedFlushScheduled = false;
+      listener->FlushCoalescedEvents();
+   }
+   m_listenersToFlush.clear();
+}
+
+void X11EventBus::PrepareQueueForInputThread(X11EventListener *listener) {
+   // A growing queue cannot be reallocated while the application may be popping from it.
+   RingBuffer<Event> &queue = listener->m_Queue;
+   if (queue.GetOverflowPolicy() == QueueOverflowPolicy::GROW) {
+      queue.Configure(queue.Capacity(), QueueOverflowPolicy::DROP_OLDEST);
+   }
+}
+
+bool X11EventBus::Dispatch(xcb_generic_event_t *event, DispatchTarget target) {
+   m_serverTime = TimeOf(event);
+   // A deferred event was already observed when the input thread dispatched it to input devices.
+   if (target != DispatchTarget::OTHERS) {
+      if (m_serverTime != 0) {
+         ClockCalibrator::GetInstance().Observe(m_serverTime, m_captureTime);
+      }
+      // Windows then report the change from the application thread, through their own routes.
+      if (m_monitorCache && m_monitorCache->IsNotifyEvent(event->response_type & ~0x80)) {
+         m_monitorCache->OnNotify(event);
+      }
+   }
+   X11EventRoute route = RouteOf(event);
+   bool leftOut = false;
+   // Listeners interested in this event on this specific window...
+   if (route.window != 0) {
+      leftOut = DispatchToRoute(RouteKey(route.eventType, route.window), route.deviceID, event, target);
+   }
+   // ...and listeners interested in this event regardless of window.
+   leftOut |= DispatchToRoute(RouteKey(route.eventType, 0), route.deviceID, event, target);
+   return leftOut;
+}
+
+bool X11EventBus::DispatchToRoute(uint64_t key, xcb_input_device_id_t deviceID, xcb_generic_event_t *event,
+                                  DispatchTarget target) {
+   auto bucket = m_routeIndex.find(key);
+   if (bucket == m_routeIndex.end()) {
+      return false;
+   }
+   bool leftOut = false;
+   auto &entries = bucket->second;
+   // Indexed, since listeners may add routes while processing an event.
+   for (size_t i = 0; i < entries.size();) {
+      X11EventListener *listener = Resolve(entries[i].handle);
+      if (!listener) {
+         // Left behind by a listener that has since unregistered.
+         entries[i] = entries.back();
+         entries.pop_back();
+         m_staleRouteCount--;
+         continue;
+      }
+      if (entries[i].deviceID == XCB_INPUT_DEVICE_ALL || entries[i].deviceID == deviceID) {
+         bool inputDevice = m_listenerSlots[entries[i].handle.slot].inputDevice;
+         if (target == DispatchTarget::ALL || inputDevice == (target == DispatchTarget::INPUT_DEVICES)) {
+            listener->ProcessGenericEvent(event);
          } else {
-            // Erase expired listeners - no longer needed.
-            iter = m_listeners.erase(iter);
+            leftOut = true;
          }
       }
+      i++;
    }
+   return leftOut;
 }
 
 void X11EventBus::FreeOldEvents() {
@@ -31,9 +617,73 @@ void X11EventBus::FreeOldEvents() {
    m_eventsToFreeNextPoll.clear();
 }
 
-void X11EventBus::RegisterListener(std::weak_ptr<X11EventListener> listener) {
-   if (!listener.expired()) {
-      m_listeners.push_back(listener);
+void X11EventBus::RegisterListener(X11EventListener *listener) {
+   std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+   if (listener->m_handle.IsValid()) {
+      return;
+   }
+   uint32_t slot = 0;
+   if (!m_freeListenerSlots.empty()) {
+      slot = m_freeListenerSlots.back();
+      m_freeListenerSlots.pop_back();
+   } else {
+      slot = static_cast<uint32_t>(m_listenerSlots.size());
+      m_listenerSlots.emplace_back();
+   }
+   m_listenerSlots[slot].listener = listener;
+   m_listenerSlots[slot].inputDevice = listener->IsInputDevice();
+   listener->m_handle = {slot, m_listenerSlots[slot].generation};
+   if (m_inputThread.joinable()) {
+      PrepareQueueForInputThread(listener);
+   }
+   for (auto route: listener->m_routes) { AddRoute(listener, route); }
+}
+
+void X11EventBus::UnregisterListener(X11EventListener *listener) {
+   std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+   ListenerHandle handle = listener->m_handle;
+   if (!handle.IsValid() || Resolve(handle) != listener) {
+      return;
+   }
+   // Bumping the generation invalidates every route that still holds the old handle.
+   m_listenerSlots[handle.slot] = {nullptr, handle.generation + 1};
+   m_freeListenerSlots.push_back(handle.slot);
+   m_staleRouteCount += listener->m_routes.size();
+   listener->m_handle = {};
+   m_heldBackListeners.erase(std::remove(m_heldBackListeners.begin(), m_heldBackListeners.end(), listener),
+                             m_heldBackListeners.end());
+}
+
+void X11EventBus::PruneStaleRoutes() {
+   for (auto bucket = m_routeIndex.begin(); bucket != m_routeIndex.end();) {
+      auto &entries = bucket->second;
+      entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                   [this](const RouteEntry &entry) { return !Resolve(entry.handle); }),
+                    entries.end());
+      bucket = entries.empty() ? m_routeIndex.erase(bucket) : std::next(bucket);
+   }
+   m_staleRouteCount = 0;
+}
+
+void X11EventBus::AddRoute(X11EventListener *listener, X11EventRoute route) {
+   std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+   m_routeIndex[RouteKey(route.eventType, route.window)].push_back({listener->m_handle, route.deviceID});
+}
+
+void X11EventBus::RemoveRoutes(const X11EventListener *listener, const std::vector<X11EventRoute> &routes) {
+   std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+   for (auto route: routes) {
+      auto bucket = m_routeIndex.find(RouteKey(route.eventType, route.window));
+      if (bucket == m_routeIndex.end()) {
+         continue;
+      }
+      auto &entries = bucket->second;
+      for (auto iter = entries.begin(); iter != entries.end(); iter++) {
+         if (iter->handle == listener->m_handle && iter->deviceID == route.deviceID) {
+            entries.erase(iter);
+            break;
+         }
+      }
    }
 }
 
@@ -44,4 +694,30 @@ X11EventBus &X11EventBus::GetInstance() {
 
 void EventBus::PollEvents() {
    X11EventBus::GetInstance().PollEvents();
-}
\ No newline at end of file
+}
+
+void EventBus::WaitEvents() {
+   X11EventBus::GetInstance().WaitEvents(-1);
+}
+
+void EventBus::WaitEvents(std::chrono::milliseconds timeout) {
+   auto clampedTimeout = std::min<std::chrono::milliseconds::rep>(
+      std::max<std::chrono::milliseconds::rep>(timeout.count(), 0), std::numeric_limits<int>::max());
+   X11EventBus::GetInstance().WaitEvents(static_cast<int>(clampedTimeout));
+}
+
+void EventBus::Wake() {
+   X11EventBus::GetInstance().Wake();
+}
+
+void EventBus::SetPollBudget(size_t maxEvents, std::chrono::microseconds maxTime) {
+   X11EventBus::GetInstance().SetPollBudget(maxEvents, maxTime);
+}
+
+void EventBus::StartInputThread() {
+   X11EventBus::GetInstance().StartInputThread();
+}
+
+void EventBus::StopInputThread() {
+   X11EventBus::GetInstance().StopInputThread();
+}
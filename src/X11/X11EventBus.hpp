@@ -9,18 +9,44 @@
  */
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "NamelessWindow/Events/EventBus.hpp"
 #include "NamelessWindow/NLSAPI.hpp"
+#include "X11EventArena.hpp"
 #include "X11EventListener.hpp"
 
 namespace NLSWIN {
 
+class X11MonitorCache;
+
 /*!
  * @brief Singleton which receives events from the X11 server and dispatches them to interested listeners.
  * @ingroup X11
+ *
+ * Listeners are not broadcast every event. Instead, each listener requests the routes it is interested in
+ * (see X11EventRoute), and the bus maintains an index from (event type, target window) to the listeners that
+ * requested it. Dispatching an event therefore only costs as much as the number of interested listeners.
+ *
+ * Listeners are held in a registry of slots, and routes refer to them by generation-checked ListenerHandle.
+ * Resolving a handle is a bounds and generation check, so no reference counts are touched while
+ * dispatching. Unregistering only invalidates the slot; routes that refer to it are pruned lazily.
+ *
+ * Optionally, a library-owned input thread can read the connection instead of the application's calls to
+ * PollEvents. The input thread dispatches to input device listeners as soon as events arrive, so input is
+ * translated and queued with accurate capture times even while the application is busy rendering, and each
+ * device sees all of its events on the same thread and in order. Events that other listeners (windows) are
+ * interested in are handed back to the application thread, and dispatched to them by its next PollEvents.
+ * None are ever discarded. Dispatching from either thread, and any changes to routes, happen under the
+ * dispatch mutex.
+ *
  * @see EventBus
  * @see X11EventListener
  */
@@ -32,24 +58,251 @@ class NLSWIN_API_PRIVATE X11EventBus {
     * @brief Dispatches all accumulated X events to interested listeners.
     *
     * This method ensures events are only sent to X11EventListeners that have explicitly subscribed to that
-    * event by setting their xcb event mask.
+    * event by setting their xcb event mask and requesting a matching route.
+    *
+    * May be called from within a listener's callback, while another poll is dispatching. The nested poll
+    * dispatches the events that have arrived since, and leaves the storage of older events alone.
     *
-    * @post All events that were dispatched by the previous call to this method are freed.
-    * @post Listeners who have since been deallocated are removed from the list of listeners.
+    * @post All events that were dispatched by the previous outermost call to this method are freed or
+    * recycled.
+    * @post Listeners who have since been deallocated no longer receive events.
     */
    void PollEvents();
-   /*! Adds a new listener to the list of registered listeners */
-   void RegisterListener(std::weak_ptr<X11EventListener> listener);
-   /*! Removes a listener from the list of registered listeners */
-   void UnregisterListener(std::weak_ptr<X11EventListener> listener);
+   /*!
+    * @brief Sleeps until X events arrive, the timeout expires, or Wake is called, and then dispatches all
+    * accumulated X events to interested listeners.
+    *
+    * @param timeoutMilliseconds The maximum time to sleep for, or a negative value to sleep indefinitely.
+    * @post All events that were dispatched by the previous call to this method are freed or recycled.
+    */
+   void WaitEvents(int timeoutMilliseconds);
+   /*!
+    * @brief Sleeps until an awaited X event arrives, or the timeout expires, and dispatches it.
+    *
+    * Every other event that arrives in the meantime is left for the next poll, so that no listener but the
+    * one waiting has its events dispatched, or its callbacks invoked, from inside the wait.
+    *
+    * @param isAwaited Whether an event is one being waited for.
+    * @param timeoutMilliseconds The maximum time to sleep for, or a negative value to sleep indefinitely.
+    * @returns False if the timeout expired first.
+    */
+   bool WaitForEvent(const std::function<bool(const xcb_generic_event_t *)> &isAwaited,
+                     int timeoutMilliseconds);
+   /*!
+    * @brief Wakes a thread blocked in WaitEvents. Safe to call from any thread.
+    * @throws PlatformInitializationException
+    */
+   void Wake();
+   /*! Limits the X events dispatched by each poll. @see EventBus::SetPollBudget */
+   void SetPollBudget(size_t maxEvents, std::chrono::microseconds maxTime);
+   /*!
+    * @brief Begins reading and dispatching X events from a dedicated thread.
+    * @post Listener queues that could grow are switched to dropping their oldest events instead.
+    */
+   void StartInputThread();
+   /*!
+    * @brief Stops the input thread, if it is running, and returns to dispatching only from PollEvents.
+    * @post Listener queues switched by StartInputThread may grow again.
+    */
+   void StopInputThread();
+   /*!
+    * @brief The mutex held while events are dispatched.
+    *
+    * Must be held by the application thread while changing any state that listeners read while processing
+    * device input events, since those may be dispatched from the input thread.
+    */
+   inline std::recursive_mutex &GetDispatchMutex() noexcept { return m_dispatchMutex; }
+   /*! Flushes a listener's coalesced events once every event of the current poll has been dispatched. */
+   void ScheduleCoalescedFlush(X11EventListener *listener);
+   /*! Forgets a flush scheduled for a listener that is being destroyed. */
+   void CancelCoalescedFlush(const X11EventListener *listener);
+   /*!
+    * @brief Remembers a listener that is holding back events beyond its queue limit, so that they are
+    * released into its queue as the application makes room.
+    *
+    * Holding back events never stops the bus. Other listeners, including those listening for the same
+    * events, keep receiving theirs.
+    */
+   void HoldBack(X11EventListener *listener);
+   /*!
+    * @brief Passes every RandR notification to the monitor cache, once, on whichever thread first reads it.
+    *
+    * The bus handles the notifications rather than each window, so the cache sees every one exactly once,
+    * however many windows there are, even if there are none.
+    */
+   void SetMonitorCache(X11MonitorCache *cache);
+   /*! Whether events are currently being read by the input thread rather than by PollEvents. */
+   inline bool IsInputThreadRunning() const noexcept { return m_inputThread.joinable(); }
+   /*! The server time of the event currently being dispatched, and when it was read from the connection. */
+   inline EventTimestamp GetCurrentTimestamp() const noexcept { return {m_serverTime, m_captureTime}; }
+   /*!
+    * @brief Creates a listener, and registers it with the bus.
+    *
+    * The returned pointer unregisters the listener as soon as the last reference to it is released, before
+    * any of its destructors run, so that the input thread can never dispatch to a partially destroyed
+    * listener.
+    */
+   template <typename ListenerType, typename... Args>
+   std::shared_ptr<ListenerType> CreateListener(Args &&...args) {
+      std::shared_ptr<ListenerType> listener(new ListenerType(std::forward<Args>(args)...),
+                                             [](ListenerType *listener) {
+                                                X11EventBus::GetInstance().UnregisterListener(listener);
+                                                delete listener;
+                                             });
+      RegisterListener(listener.get());
+      return listener;
+   }
+   /*! Adds a new listener to the bus, and begins dispatching events along all of its requested routes. */
+   void RegisterListener(X11EventListener *listener);
+   /*! Stops dispatching events to a listener, in constant time. Does nothing if it is not registered. */
+   void UnregisterListener(X11EventListener *listener);
+   /*! Begins dispatching events matching a route to an already registered listener. */
+   void AddRoute(X11EventListener *listener, X11EventRoute route);
+   /*! Stops dispatching events matching any of the given routes to a listener. */
+   void RemoveRoutes(const X11EventListener *listener, const std::vector<X11EventRoute> &routes);
 
    private:
-   std::vector<std::weak_ptr<X11EventListener>> m_listeners;
+   struct ListenerSlot {
+      X11EventListener *listener {nullptr};
+      uint32_t generation {0};
+      /*! Cached X11EventListener::IsInputDevice, so that dispatching never needs a virtual call. */
+      bool inputDevice {false};
+   };
+   /*! Which of the listeners along a route an event is dispatched to. */
+   enum class DispatchTarget {
+      ALL,
+      INPUT_DEVICES, /*!< Only listeners that translate device input, from the input thread. */
+      OTHERS         /*!< Every listener except those, from the application thread. */
+   };
+   std::vector<ListenerSlot> m_listenerSlots;
+   std::vector<uint32_t> m_freeListenerSlots;
+   struct RouteEntry {
+      ListenerHandle handle;
+      xcb_input_device_id_t deviceID {XCB_INPUT_DEVICE_ALL};
+   };
+   /*! Once this many routes refer to unregistered listeners, BeginPoll prunes them all. */
+   static constexpr size_t STALE_ROUTE_SWEEP_THRESHOLD = 64;
+   size_t m_staleRouteCount {0};
+   /*! Keyed by event type in the upper 32 bits, and the target window (or 0) in the lower 32 bits. */
+   std::unordered_map<uint64_t, std::vector<RouteEntry>> m_routeIndex;
+   X11EventArena m_eventArena;
+   /*! Events too large to be copied into the arena. */
    std::vector<xcb_generic_event_t *> m_eventsToFreeNextPoll;
+   /*! An eventfd written to by Wake, so that another thread can interrupt WaitEvents. */
+   int m_wakeFd {-1};
+   std::recursive_mutex m_dispatchMutex;
+   std::chrono::steady_clock::time_point m_captureTime;
+   xcb_timestamp_t m_serverTime {0};
+   /*! The most X events to read from the connection per poll, or 0 for no limit. */
+   size_t m_pollBudgetEvents {0};
+   /*! How long to keep reading X events from the connection per poll, or 0 for no limit. */
+   std::chrono::microseconds m_pollBudgetTime {0};
+
+   struct DeferredEvent {
+      /*! Allocated by libxcb, and owned by the bus until the poll that dispatches it frees it. */
+      xcb_generic_event_t *event {nullptr};
+      std::chrono::steady_clock::time_point captureTime;
+      /*! OTHERS if input devices have already received the event from the input thread. */
+      DispatchTarget target {DispatchTarget::OTHERS};
+   };
+   /*!
+    * Events read by the input thread that listeners other than input devices are interested in, and events
+    * left over by WaitForEvent, waiting to be dispatched by PollEvents. Guarded by the dispatch mutex, and
+    * never discards any.
+    */
+   std::vector<DeferredEvent> m_deferredEvents;
+   /*! Spare storage for the deferred events being dispatched, swapped out to keep both allocations. */
+   std::vector<DeferredEvent> m_dispatchingEvents;
+   /*!
+    * The number of polls in progress, which is more than one while a listener polls from a callback. Only the
+    * outermost poll recycles the storage of events, since the polls around a nested one are still using it.
+    */
+   unsigned int m_dispatchDepth {0};
+   std::vector<X11EventListener *> m_listenersToFlush;
+   std::vector<X11EventListener *> m_heldBackListeners;
+   /*! Receives RandR notifications, once it has selected them. */
+   X11MonitorCache *m_monitorCache {nullptr};
+   /*! How often the input thread checks whether the application has made room for held back events. */
+   static constexpr auto HOLD_BACK_RETRY_INTERVAL = std::chrono::milliseconds(1);
+   std::thread m_inputThread;
+   std::atomic<bool> m_stopInputThread {false};
+   /*! Set by the input thread as it exits, whether asked to or because the connection failed. */
+   std::atomic<bool> m_inputThreadExited {false};
+   /*! The socket of the connection, so that the destructor can stop the input thread without libxcb. */
+   int m_inputThreadSocket {-1};
+   xcb_window_t m_inputThreadWindow {0};
+   static inline uint64_t RouteKey(uint16_t eventType, xcb_window_t window) noexcept {
+      return (static_cast<uint64_t>(eventType) << 32) | window;
+   }
+   /*!
+    * Dispatches an event to the targeted listeners along its route.
+    * @returns True if any listener along the route was left out because it was not targeted.
+    */
+   bool Dispatch(xcb_generic_event_t *event, DispatchTarget target);
+   bool DispatchToRoute(uint64_t key, xcb_input_device_id_t deviceID, xcb_generic_event_t *event,
+                        DispatchTarget target);
    void FreeOldEvents();
-   X11EventBus() = default;
+   /*! The listener a handle refers to, or nullptr if it has since unregistered. */
+   inline X11EventListener *Resolve(ListenerHandle handle) const noexcept {
+      if (handle.slot >= m_listenerSlots.size()) {
+         return nullptr;
+      }
+      const ListenerSlot &slot = m_listenerSlots[handle.slot];
+      return slot.generation == handle.generation ? slot.listener : nullptr;
+   }
+   /*! Removes every route that refers to an unregistered listener. */
+   void PruneStaleRoutes();
+   /*! Recycles the storage of all events dispatched by the previous poll. Only the outermost poll may. */
+   void BeginPoll();
+   /*! Stores an event returned by libxcb for the duration of this poll, and dispatches it. */
+   void StoreAndDispatch(xcb_generic_event_t *event);
+   /*! Dispatches all deferred events, an optional already dequeued event, and then all pending X events. */
+   void DispatchPendingEvents(xcb_generic_event_t *queuedEvent);
+   /*!
+    * Dispatches the events waiting on the connection, within the poll budget. Reads from the socket at most
+    * once, and otherwise only drains what libxcb has already buffered.
+    */
+   void DrainConnection();
+   /*! Blocks until the X connection or the wake eventfd becomes readable, or the timeout expires. */
+   void WaitForActivity(bool includeConnection, int timeoutMilliseconds);
+   void InputThreadMain();
+   /*!
+    * Dispatches the oldest awaited event among the deferred events, or else among those waiting on the
+    * connection, deferring any others read on the way. Must be called with the dispatch mutex held.
+    * @returns False if there was none.
+    */
+   bool DispatchAwaitedEvent(const std::function<bool(const xcb_generic_event_t *)> &isAwaited);
+   /*!
+    * Waits for the input thread's next event. While listeners are holding back events, they are released
+    * as the application makes room in the meantime.
+    * @returns Nullptr if the connection has failed.
+    */
+   xcb_generic_event_t *WaitForInputThreadEvent();
+   /*!
+    * Dispatches an event read by the input thread to input devices, defers it for any other listeners, and
+    * frees it.
+    */
+   void HandOff(xcb_generic_event_t *event);
+   /*! Writes to the wake eventfd. @returns False if it could not be written to. */
+   bool SignalWake() noexcept;
+   /*!
+    * Joins an input thread that exited without being asked to, because the connection failed, so that
+    * PollEvents reads the connection itself again. Must be called with the dispatch mutex held.
+    */
+   void ReapInputThread();
+   /*! Switches every listener queue back to what it was before StartInputThread. */
+   void RestoreQueuesAfterInputThread();
+   void PrepareQueueForInputThread(X11EventListener *listener);
+   void FlushCoalescedEvents();
+   /*!
+    * Moves held back events into listener queues as far as they have room.
+    * @returns True if any events were moved.
+    */
+   bool ReleaseHeldBackEvents();
+   X11EventBus();
+   ~X11EventBus();
    X11EventBus(X11EventBus const &) = delete;
    void operator=(X11EventBus const &) = delete;
 };
 
-}  // namespace NLSWIN
\ No newline at end of file
+}  // namespace NLSWIN
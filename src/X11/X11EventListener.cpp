@@ -1,22 +1,230 @@
 #include "X11EventListener.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+#include "../Common/ClockCalibrator.hpp"
+#include "../Common/EventCoalescing.hpp"
+#include "../Common/EventRecordWriter.hpp"
+#include "../Common/LatencyRecorder.hpp"
 #include "NamelessWindow/Exceptions.hpp"
+#include "X11EventBus.hpp"
 
 using namespace NLSWIN;
 
+X11EventListener::~X11EventListener() {
+   // Our routes are left behind, and pruned by the bus once it notices our handle is stale.
+   X11EventBus::GetInstance().UnregisterListener(this);
+   if (m_coalescedFlushScheduled) {
+      X11EventBus::GetInstance().CancelCoalescedFlush(this);
+   }
+   if (EventRecordWriter::GetInstance().IsRecording()) {
+      EventRecordWriter::GetInstance().Forget(this);
+   }
+}
+
 bool X11EventListener::HasEvent() const noexcept {
-   return !m_Queue.empty();
+   return !m_Queue.Empty();
 }
 
 void X11EventListener::PushEvent(Event event) {
-   m_Queue.push(event);
+   if (!IsEventWanted(event.index())) {
+      return;
+   }
+   StampEvent(event, CurrentTimestamp());
+   RecordEvent(event);
+   TrackInputState(event);
+   LatencyRecorder::GetInstance().RecordQueued(event);
+   if (m_coalesceEvents) {
+      if (IsCoalescible(event)) {
+         for (auto &pending: m_coalescedEvents) {
+            if (TryCoalesce(pending, event)) {
+               return;
+            }
+         }
+         m_coalescedEvents.push_back(std::move(event));
+         if (!m_coalescedFlushScheduled) {
+            m_coalescedFlushScheduled = true;
+            X11EventBus::GetInstance().ScheduleCoalescedFlush(this);
+         }
+         return;
+      }
+      // Anything else must stay behind the coalesced events that arrived before it.
+      FlushCoalescedEvents();
+   }
+   Enqueue(std::move(event));
+}
+
+void X11EventListener::Enqueue(Event &&event) {
+   if (m_queuePolicy == EventQueuePolicy::GROW) {
+      // While the input thread is running, the queue drops its oldest event instead of growing.
+      if (m_Queue.GetOverflowPolicy() == QueueOverflowPolicy::DROP_OLDEST &&
+          m_Queue.Size() >= m_Queue.Capacity()) {
+         m_queueCounters.CountDropped();
+      }
+      m_Queue.Push(std::move(event));
+      m_queueCounters.ObserveSize(m_Queue.Size());
+      return;
+   }
+   bool isMotion = IsMotionEvent(event);
+   // Anything held back must reach the queue first, to keep events in order.
+   if (ReleaseHeldBackEvents() && m_Queue.Size() < m_queueLimit && m_Queue.TryPush(event, isMotion)) {
+      m_queueCounters.ObserveSize(m_Queue.Size());
+      return;
+   }
+   if (m_queuePolicy == EventQueuePolicy::DROP_NEWEST) {
+      m_queueCounters.CountDropped();
+      return;
+   }
+   if (m_queuePolicy == EventQueuePolicy::DROP_OLDEST_MOTION_FIRST &&
+       m_Queue.Size() + m_heldBackEvents.size() >= m_queueLimit) {
+      // The oldest motion goes first, whether it is queued or held back, and queued events are older than
+      // held back ones. Only once there is no motion left does the oldest discrete event go.
+      auto motion = std::find_if(m_heldBackEvents.begin(), m_heldBackEvents.end(), IsMotionEvent);
+      if (m_Queue.TryDiscardOldestExpendable()) {
+         m_queueCounters.CountDropped();
+      } else if (motion != m_heldBackEvents.end()) {
+         m_heldBackEvents.erase(motion);
+         m_queueCounters.CountDropped();
+      } else if (isMotion) {
+         m_queueCounters.CountDropped();
+         return;
+      } else if (m_Queue.TryDiscardOldest()) {
+         m_queueCounters.CountDropped();
+      } else if (!m_heldBackEvents.empty()) {
+         m_heldBackEvents.erase(m_heldBackEvents.begin());
+         m_queueCounters.CountDropped();
+      }
+      // If the application is popping the oldest event right now, this one is held until it has.
+   }
+   // Under EventQueuePolicy::BLOCK nothing is discarded. The events wait here for this listener alone.
+   m_heldBackEvents.push_back(std::move(event));
+   // A queued event discarded from the middle of the queue leaves room that can only be used once the
+   // application has popped the events before it, so held back events are released whenever there is room.
+   if (!ReleaseHeldBackEvents()) {
+      X11EventBus::GetInstance().HoldBack(this);
+   }
+   m_heldBackCount.store(m_heldBackEvents.size(), std::memory_order_relaxed);
+   m_queueCounters.ObserveSize(m_Queue.Size() + m_heldBackEvents.size());
+}
+
+bool X11EventListener::ReleaseHeldBackEvents() {
+   if (m_heldBackEvents.empty()) {
+      return true;
+   }
+   size_t released = 0;
+   for (; released < m_heldBackEvents.size(); released++) {
+      Event &event = m_heldBackEvents[released];
+      if (m_queuePolicy == EventQueuePolicy::GROW) {
+         m_Queue.Push(std::move(event));
+      } else if (m_Queue.Size() >= m_queueLimit || !m_Queue.TryPush(event, IsMotionEvent(event))) {
+         break;
+      }
+   }
+   m_heldBackEvents.erase(m_heldBackEvents.begin(), m_heldBackEvents.begin() + released);
+   m_heldBackCount.store(m_heldBackEvents.size(), std::memory_order_relaxed);
+   return m_heldBackEvents.empty();
+}
+
+void X11EventListener::RecordEvent(const Event &event) const {
+   if (EventRecordWriter::GetInstance().IsRecording()) {
+      EventRecordWriter::GetInstance().Record(this, event);
+   }
+}
+
+EventTimestamp X11EventListener::CurrentTimestamp() const {
+   EventTimestamp timestamp = X11EventBus::GetInstance().GetCurrentTimestamp();
+   timestamp.queueTime = std::chrono::steady_clock::now();
+   return timestamp;
+}
+
+void X11EventListener::FlushCoalescedEvents() {
+   for (auto &pending: m_coalescedEvents) { Enqueue(std::move(pending)); }
+   m_coalescedEvents.clear();
+}
+
+void X11EventListener::SetEventCoalescing(bool enabled) {
+   std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
+   m_coalesceEvents = enabled;
+   if (!enabled) {
+      FlushCoalescedEvents();
+   }
+}
+
+void X11EventListener::UpdateEventCallbacks(const std::function<void()> &update) {
+   std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
+   update();
+}
+
+void X11EventListener::ConfigureQueue(size_t capacity, QueueOverflowPolicy policy) {
+   m_Queue.Configure(capacity, policy);
+}
+
+void X11EventListener::SetEventQueueLimit(size_t capacity, EventQueuePolicy policy) {
+   std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
+   if (capacity == 0) {
+      policy = EventQueuePolicy::GROW;
+   }
+   size_t queued = m_Queue.Size();
+   if (policy == EventQueuePolicy::GROW) {
+      // Must match what PrepareQueueForInputThread would have chosen.
+      m_Queue.Configure(std::max(capacity, m_Queue.Capacity()),
+                        X11EventBus::GetInstance().IsInputThreadRunning() ? QueueOverflowPolicy::DROP_OLDEST
+                                                                          : QueueOverflowPolicy::GROW);
+   } else {
+      // The queue never overflows by itself, since nothing is pushed onto it beyond the limit.
+      m_Queue.Configure(capacity, QueueOverflowPolicy::DROP_NEWEST);
+      Event discarded;
+      while (m_Queue.Size() > capacity && m_Queue.TryPop(discarded)) {}
+   }
+   m_queueCounters.CountDropped(queued - m_Queue.Size());
+   m_queueLimit = policy == EventQueuePolicy::GROW ? 0 : capacity;
+   m_queuePolicy = policy;
+   ReleaseHeldBackEvents();
+}
+
+EventQueueStats X11EventListener::GetEventQueueStats() const noexcept {
+   return m_queueCounters.GetStats(m_queueLimit,
+                                   m_Queue.Size() + m_heldBackCount.load(std::memory_order_relaxed));
+}
+
+void X11EventListener::ResetEventQueueStats() noexcept {
+   m_queueCounters.Reset(m_Queue.Size() + m_heldBackCount.load(std::memory_order_relaxed));
 }
 
 Event X11EventListener::GetNextEvent() {
-   if (!HasEvent()) {
+   Event event;
+   if (!m_Queue.TryPop(event)) {
       throw EmptyEventQueueException();
    }
-   Event test = std::move(m_Queue.front());
-   m_Queue.pop();
-   return test;
-}
\ No newline at end of file
+   LatencyRecorder::GetInstance().RecordDelivered(&event, 1);
+   return event;
+}
+
+size_t X11EventListener::DrainEvents(Event *out, size_t maxEvents) {
+   size_t count = 0;
+   while (count < maxEvents && m_Queue.TryPop(out[count])) { count++; }
+   LatencyRecorder::GetInstance().RecordDelivered(out, count);
+   return count;
+}
+
+void X11EventListener::ListenFor(X11EventRoute route) {
+   if (std::find(m_routes.begin(), m_routes.end(), route) != m_routes.end()) {
+      return;
+   }
+   m_routes.push_back(route);
+   // Not registered yet - the bus picks up all of our routes on registration.
+   if (m_handle.IsValid()) {
+      X11EventBus::GetInstance().AddRoute(this, route);
+   }
+}
+
+void X11EventListener::StopListeningFor(X11EventRoute route) {
+   auto iter = std::find(m_routes.begin(), m_routes.end(), route);
+   if (iter == m_routes.end()) {
+      return;
+   }
+   m_routes.erase(iter);
+   X11EventBus::GetInstance().RemoveRoutes(this, {route});
+}
@@ -12,14 +12,70 @@
 #include <xcb/xcb.h>
 #include <xcb/xinput.h>
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
-#include <queue>
+#include <vector>
 
+#include "../Common/EventQueueLimits.hpp"
+#include "../Common/LatencyRecorder.hpp"
+#include "../Common/RingBuffer.hpp"
 #include "NamelessWindow/Events/Event.hpp"
 #include "NamelessWindow/Events/EventListener.hpp"
 #include "NamelessWindow/NLSAPI.hpp"
 
 namespace NLSWIN {
+
+/*!
+ * @brief Describes a class of X events that a listener wishes to receive from the X11EventBus.
+ * @ingroup X11
+ *
+ * Core events are identified by their response type. XInput2 events all share the XCB_GE_GENERIC response
+ * type, so they are identified by their XI2 event type offset by XI2_ROUTE_OFFSET instead.
+ */
+struct NLSWIN_API_PRIVATE X11EventRoute {
+   /*! Offset applied to XI2 event types so that they never collide with core response types. */
+   static constexpr uint16_t XI2_ROUTE_OFFSET = 0x80;
+
+   uint16_t eventType {0};                                /*!< The core response type or offset XI2 type. */
+   xcb_window_t window {0};                               /*!< The target window, or 0 for any window. */
+   xcb_input_device_id_t deviceID {XCB_INPUT_DEVICE_ALL}; /*!< The source device, or XCB_INPUT_DEVICE_ALL. */
+
+   /*! Route for a core X event, optionally restricted to a single window. */
+   static constexpr X11EventRoute Core(uint8_t responseType, xcb_window_t window = 0) {
+      return {responseType, window, XCB_INPUT_DEVICE_ALL};
+   }
+   /*! Route for an XInput2 event, optionally restricted to a single window and/or device. */
+   static constexpr X11EventRoute XI2(uint16_t xi2EventType, xcb_window_t window = 0,
+                                      xcb_input_device_id_t deviceID = XCB_INPUT_DEVICE_ALL) {
+      return {static_cast<uint16_t>(XI2_ROUTE_OFFSET + xi2EventType), window, deviceID};
+   }
+
+   bool operator==(const X11EventRoute &other) const noexcept {
+      return eventType == other.eventType && window == other.window && deviceID == other.deviceID;
+   }
+};
+
+/*!
+ * @brief Identifies a listener's slot in the X11EventBus registry.
+ * @ingroup X11
+ *
+ * Slots are reused once their listener unregisters, and each reuse increments the slot's generation, so a
+ * handle held by a stale route can never resolve to the slot's new listener.
+ */
+struct NLSWIN_API_PRIVATE ListenerHandle {
+   static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+   uint32_t slot {INVALID_SLOT}; /*!< Index into the registry. */
+   uint32_t generation {0};      /*!< Must match the slot's generation for the handle to be valid. */
+
+   [[nodiscard]] bool IsValid() const noexcept { return slot != INVALID_SLOT; }
+   bool operator==(const ListenerHandle &other) const noexcept {
+      return slot == other.slot && generation == other.generation;
+   }
+};
+
 /*!
  * @brief An interface implemented by all classes who wish to receive X events.
  * @ingroup X11
@@ -27,6 +83,9 @@ namespace NLSWIN {
  */
 class NLSWIN_API_PRIVATE X11EventListener : virtual public EventListener {
    public:
+   /*! The queue capacity of listeners that do not configure their own. */
+   static constexpr size_t DEFAULT_QUEUE_CAPACITY = 64;
+
    /*!
     * @brief Check if the listener has an event in its queue.
     *
@@ -40,24 +99,131 @@ class NLSWIN_API_PRIVATE X11EventListener : virtual public EventListener {
     * @return The next event.
     */
    [[nodiscard]] Event GetNextEvent() override;
+   /*!
+    * @brief Pops up to maxEvents events from the queue.
+    *
+    * @return The number of events popped.
+    */
+   size_t DrainEvents(Event *out, size_t maxEvents) override;
+   using EventListener::DrainEvents;
+   void SetEventCoalescing(bool enabled) override;
+   void SetEventQueueLimit(size_t capacity, EventQueuePolicy policy) override;
+   [[nodiscard]] EventQueueStats GetEventQueueStats() const noexcept override;
+   void ResetEventQueueStats() noexcept override;
    /*!
     * @brief Takes a generic X event, and either constructs a platform-independent Event object to store in
     * its queue, or discards the event.
     *
+    * Only events matching one of the routes this listener has requested with ListenFor are ever passed to
+    * this method.
+    *
     * @param event The generic X event received from the X11EventBus to process.
     */
    virtual void ProcessGenericEvent(xcb_generic_event_t *event) = 0;
+   /*!
+    * @brief Whether this listener translates device input, and keeps no state that the application reads
+    * without holding the dispatch mutex.
+    *
+    * While the input thread is running, it dispatches every event to these listeners itself. All others
+    * receive their events from the application thread. Must not change once the listener is registered.
+    */
+   [[nodiscard]] virtual bool IsInputDevice() const noexcept { return false; }
+
+   virtual ~X11EventListener();
 
    protected:
    /*!
     * @brief Push a new processed platform-independent event onto this listener's queue of events.
     *
+    * The event is stamped with the server time and capture time of the X event currently being dispatched.
+    *
     * @param event The event to push.
     */
    void PushEvent(Event event);
+   /*!
+    * @brief Delivers a translated event to its registered callback, or otherwise pushes it onto the queue.
+    *
+    * Listeners should push the concrete event type where possible, so that events with a callback are never
+    * wrapped in an Event.
+    *
+    * @param event The event to deliver.
+    */
+   template <typename EventType>
+   void PushEvent(EventType event) {
+      if (!IsEventWanted<EventType>()) {
+         return;
+      }
+      if (const auto &callback = GetEventCallback<EventType>(); callback) {
+         event.timestamp = CurrentTimestamp();
+         RecordEvent(event);
+         TrackInputState(event);
+         LatencyRecorder::GetInstance().RecordCallback(EventIndex<EventType>::value, event.timestamp);
+         callback(event);
+         return;
+      }
+      PushEvent(Event(std::move(event)));
+   }
+   /*!
+    * @brief Changes the capacity of this listener's queue of events, and what happens once it is full.
+    *
+    * Listeners that receive high frequency input should pick a capacity large enough to hold a frame's worth
+    * of events, so the queue never needs to grow. Growth is not possible while the input thread is running,
+    * in which case the oldest events are dropped instead. Replaced by any limit set by the application with
+    * SetEventQueueLimit.
+    *
+    * @param capacity The number of events the queue can hold. Rounded up to the next power of two.
+    * @param policy What to do with events pushed while the queue is full.
+    */
+   void ConfigureQueue(size_t capacity, QueueOverflowPolicy policy);
+   /*!
+    * @brief Request that events matching a route be dispatched to this listener.
+    *
+    * May be called before the listener has been registered with the X11EventBus, in which case the route
+    * takes effect on registration.
+    *
+    * @param route The class of events to receive.
+    */
+   void ListenFor(X11EventRoute route);
+   /*!
+    * @brief Stop dispatching events matching a route previously requested with ListenFor.
+    *
+    * @param route The class of events to no longer receive.
+    */
+   void StopListeningFor(X11EventRoute route);
+   void UpdateEventCallbacks(const std::function<void()> &update) override;
 
    private:
-   std::queue<Event> m_Queue;
+   friend class X11EventBus;
+   RingBuffer<Event> m_Queue {DEFAULT_QUEUE_CAPACITY};
+   std::vector<X11EventRoute> m_routes;
+   /*! Set by the X11EventBus on registration, and reset on unregistration. */
+   ListenerHandle m_handle;
+   bool m_coalesceEvents {false};
+   bool m_coalescedFlushScheduled {false};
+   /*! At most one event per coalescible stream, held back until the end of the current poll. */
+   std::vector<Event> m_coalescedEvents;
+   /*! Moves all held back coalesced events into the queue, in the order their streams began. */
+   void FlushCoalescedEvents();
+   /*! The limit set with SetEventQueueLimit, or 0 if the queue may grow. */
+   size_t m_queueLimit {0};
+   EventQueuePolicy m_queuePolicy {EventQueuePolicy::GROW};
+   /*!
+    * Events that arrived while the queue was at its limit, in order, waiting for the application to make
+    * room. Unlike the queue, they belong to the dispatching thread alone. Under EventQueuePolicy::BLOCK they
+    * are never discarded, and grow for as long as the application does not drain the queue.
+    */
+   std::vector<Event> m_heldBackEvents;
+   /*! The size of m_heldBackEvents, for the application thread to read. */
+   std::atomic<size_t> m_heldBackCount {0};
+   EventQueueCounters m_queueCounters;
+   /*! Pushes a stamped event onto the queue, applying the queue limit. */
+   void Enqueue(Event &&event);
+   /*! Moves held back events into the queue while there is room. @returns True if none are left. */
+   bool ReleaseHeldBackEvents();
+   /*! The timestamp of the X event currently being dispatched, with the queue time set to now. */
+   EventTimestamp CurrentTimestamp() const;
+   /*! Appends a stamped event to the running EventRecorder recording, if there is one. */
+   void RecordEvent(const Event &event) const;
 };
 
-}  // namespace NLSWIN
\ No newline at end of file
+}  // namespace NLSWIN
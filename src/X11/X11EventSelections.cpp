@@ -0,0 +1,78 @@
+#include "X11EventSelections.hpp"
+
+#include "X11Util.hpp"
+#include "XConnection.h"
+
+using namespace NLSWIN;
+
+X11EventSelections &X11EventSelections::GetInstance() {
+   static X11EventSelections instance;
+   return instance;
+}
+
+bool X11EventSelections::Selection::Replace(uint32_t oldMask, uint32_t newMask) noexcept {
+   uint32_t selectedBefore = selected;
+   selected = 0;
+   for (size_t bit = 0; bit < counts.size(); bit++) {
+      // A contribution to a window that was forgotten in the meantime has nothing left to remove.
+      if ((oldMask & (1u << bit)) && counts[bit] > 0) {
+         counts[bit]--;
+      }
+      if (newMask & (1u << bit)) {
+         counts[bit]++;
+      }
+      if (counts[bit] > 0) {
+         selected |= 1u << bit;
+      }
+   }
+   return selected != selectedBefore;
+}
+
+void X11EventSelections::SelectXI2(xcb_window_t window, xcb_input_device_id_t deviceID, uint32_t oldMask,
+                                   uint32_t newMask) {
+   if (oldMask == newMask) {
+      return;
+   }
+   std::lock_guard<std::mutex> lock(m_mutex);
+   auto key = std::make_pair(window, deviceID);
+   Selection &selection = m_xi2Selections[key];
+   if (selection.Replace(oldMask, newMask)) {
+      UTIL::XI2EventMask mask;
+      mask.header.deviceid = deviceID;
+      // Length of zero clears the mask on the X server.
+      mask.header.mask_len = selection.selected ? sizeof(mask.mask) / sizeof(uint32_t) : 0;
+      mask.mask = static_cast<xcb_input_xi_event_mask_t>(selection.selected);
+      xcb_input_xi_select_events(XConnection::GetConnection(), window, 1, &mask.header);
+      xcb_flush(XConnection::GetConnection());  // To ensure the X server definitely gets the request.
+   }
+   if (!selection.selected) {
+      m_xi2Selections.erase(key);
+   }
+}
+
+void X11EventSelections::SelectCore(xcb_window_t window, uint32_t oldMask, uint32_t newMask) {
+   if (oldMask == newMask) {
+      return;
+   }
+   std::lock_guard<std::mutex> lock(m_mutex);
+   Selection &selection = m_coreSelections[window];
+   if (selection.Replace(oldMask, newMask)) {
+      xcb_change_window_attributes(XConnection::GetConnection(), window, XCB_CW_EVENT_MASK,
+                                   &selection.selected);
+      xcb_flush(XConnection::GetConnection());
+   }
+   if (!selection.selected) {
+      m_coreSelections.erase(window);
+   }
+}
+
+void X11EventSelections::Forget(xcb_window_t window) {
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_coreSelections.erase(window);
+   for (auto iter = m_xi2Selections.lower_bound({window, 0}); iter != m_xi2Selections.end();) {
+      if (iter->first.first != window) {
+         break;
+      }
+      iter = m_xi2Selections.erase(iter);
+   }
+}
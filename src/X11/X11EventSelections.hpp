@@ -0,0 +1,68 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @addtogroup X11 Linux X11 API
+ * @brief Platform-specific X11 implementation of the API
+ */
+#pragma once
+
+#include <xcb/xcb.h>
+#include <xcb/xinput.h>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "NamelessWindow/NLSAPI.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief Singleton record of the event masks selected on each window, on behalf of every listener.
+ * @ingroup X11
+ *
+ * The X server keeps a single XI2 mask for each window and device, and a single core mask for each window,
+ * per client, and selecting a mask replaces whatever the connection had selected before. Listeners that
+ * share a window and device (two keyboards for the same device, or a raw mouse and the cursor on the root
+ * window) therefore never select masks directly. Each instead changes its own contribution here, and the
+ * union of every contribution is selected. A bit stays selected for as long as any listener still wants it.
+ */
+class NLSWIN_API_PRIVATE X11EventSelections {
+   public:
+   /*! Singleton Accessor */
+   static X11EventSelections &GetInstance();
+   /*!
+    * @brief Replaces one listener's contribution to the XI2 events selected on a window for a device.
+    *
+    * @param oldMask The contribution the listener made before, which it no longer wants.
+    * @param newMask The contribution it wants now.
+    */
+   void SelectXI2(xcb_window_t window, xcb_input_device_id_t deviceID, uint32_t oldMask, uint32_t newMask);
+   /*! Replaces one listener's contribution to the core events selected on a window. */
+   void SelectCore(xcb_window_t window, uint32_t oldMask, uint32_t newMask);
+   /*! Drops every selection on a window that has been destroyed, which the server has already dropped. */
+   void Forget(xcb_window_t window);
+
+   private:
+   /*! How many contributions want each bit of a mask. */
+   struct Selection {
+      std::array<uint16_t, 32> counts {};
+      uint32_t selected {0};
+      /*! @returns True if the union of the contributions changed. */
+      bool Replace(uint32_t oldMask, uint32_t newMask) noexcept;
+   };
+   std::mutex m_mutex;
+   std::map<std::pair<xcb_window_t, xcb_input_device_id_t>, Selection> m_xi2Selections;
+   std::unordered_map<xcb_window_t, Selection> m_coreSelections;
+   X11EventSelections() = default;
+   X11EventSelections(X11EventSelections const &) = delete;
+   void operator=(X11EventSelections const &) = delete;
+};
+
+}  // namespace NLSWIN
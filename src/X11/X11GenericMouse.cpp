@@ -21,7 +21,8 @@ ButtonValue X11GenericMouse::TranslateButton(uint16_t detail) {
    return m_buttonTranslationTable.at(detail);
 }
 
-Event X11GenericMouse::PackageNewDeltaEvents(xcb_input_raw_button_press_event_t *event) {
+std::optional<RawMouseDeltaMovementEvent>
+X11GenericMouse::PackageNewDeltaEvents(xcb_input_raw_button_press_event_t *event) {
    xcb_input_raw_button_press_event_t *buttonEvent =
       reinterpret_cast<xcb_input_raw_button_press_event_t *>(event);
 
@@ -30,7 +31,7 @@ Event X11GenericMouse::PackageNewDeltaEvents(xcb_input_raw_button_press_event_t
    // real mouse motion events, while 2 and 3 appear to be horz/vertical valuators for scroll.
    auto mask = xcb_input_raw_button_press_valuator_mask(buttonEvent);
    if ((mask[0] & (1 << 2)) || (mask[0] & (1 << 3))) {
-      return std::monostate();
+      return std::nullopt;
    }
    auto rawAxisValues =
       xcb_input_raw_button_press_axisvalues_raw((xcb_input_raw_button_press_event_t *)event);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <unordered_map>
 #include <utility>
 
@@ -12,7 +13,8 @@ class NLSWIN_API_PRIVATE X11GenericMouse {
    protected:
    float TranslateXCBFloat(xcb_input_fp1616_t inval) const noexcept;
    float TranslateXCBFloat(xcb_input_fp3232_t inval) const noexcept;
-   Event PackageNewDeltaEvents(xcb_input_raw_button_press_event_t *event);
+   /*! Translates a raw motion event, or returns nothing for motion of the scroll valuators. */
+   std::optional<RawMouseDeltaMovementEvent> PackageNewDeltaEvents(xcb_input_raw_button_press_event_t *event);
    ButtonValue TranslateButton(uint16_t detail);
 
    private:
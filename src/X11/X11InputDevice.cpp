@@ -1,42 +1,64 @@
 #include "X11InputDevice.hpp"
 
+#include <mutex>
+
+#include "X11EventBus.hpp"
+#include "X11EventSelections.hpp"
 #include "X11Util.hpp"
 #include "X11Window.hpp"
 
 using namespace NLSWIN;
 
+X11InputDevice::~X11InputDevice() {
+   std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
+   for (const auto &[handle, window]: m_subscribedWindows) {
+      if (!window.expired()) {
+         X11EventSelections::GetInstance().SelectXI2(handle, m_deviceID,
+                                                     m_windowSpecificXInput2SubscribedEvents, 0);
+      }
+   }
+}
+
 void X11InputDevice::SubscribeToWindow(const std::weak_ptr<Window> x11Window) {
+   // Subscribed windows are read while translating input, which may be happening on the input thread.
+   std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
    if (!x11Window.expired()) {
       std::shared_ptr<X11Window> windowSharedPtr = std::static_pointer_cast<X11Window>(x11Window.lock());
       m_subscribedWindows.insert(
          std::make_pair(windowSharedPtr->GetX11ID(), std::static_pointer_cast<X11Window>(windowSharedPtr)));
-
-      if (m_windowSpecificXInput2SubscribedEvents) {
-         UTIL::XI2EventMask mask;
-         mask.header.deviceid = m_deviceID;
-         mask.header.mask_len = sizeof(mask.mask) / sizeof(uint32_t);
-         mask.mask = m_windowSpecificXInput2SubscribedEvents;
-         xcb_input_xi_select_events_checked(XConnection::GetConnection(), windowSharedPtr->GetX11ID(), 1,
-                                            &mask.header);
-         xcb_flush(XConnection::GetConnection());
-      }
+      SelectWindowXInput2Events(windowSharedPtr->GetX11ID(), (xcb_input_xi_event_mask_t)0,
+                                m_windowSpecificXInput2SubscribedEvents);
    }
 }
 
 void X11InputDevice::UnsubscribeFromWindow(const std::weak_ptr<Window> x11Window) {
+   std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
    if (!x11Window.expired()) {
       std::shared_ptr<X11Window> windowSharedPtr = std::static_pointer_cast<X11Window>(x11Window.lock());
       m_subscribedWindows.erase(windowSharedPtr->GetX11ID());
-
-      UTIL::XI2EventMask mask;
-      mask.header.deviceid = m_deviceID;
-      mask.header.mask_len = 0;  // Length of zero clears the mask on the X server,
-      xcb_input_xi_select_events_checked(XConnection::GetConnection(), windowSharedPtr->GetX11ID(), 1,
-                                         &mask.header);
-      xcb_flush(XConnection::GetConnection());
+      SelectWindowXInput2Events(windowSharedPtr->GetX11ID(), m_windowSpecificXInput2SubscribedEvents,
+                                (xcb_input_xi_event_mask_t)0);
    }
 }
 
 void X11InputDevice::SubscribeToWindowSpecificXInput2Events(xcb_input_xi_event_mask_t eventMask) {
+   std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
+   for (const auto &[handle, window]: m_subscribedWindows) {
+      SelectWindowXInput2Events(handle, m_windowSpecificXInput2SubscribedEvents, eventMask);
+   }
    m_windowSpecificXInput2SubscribedEvents = eventMask;
-}
\ No newline at end of file
+}
+
+void X11InputDevice::SelectWindowXInput2Events(xcb_window_t window, xcb_input_xi_event_mask_t oldMask,
+                                               xcb_input_xi_event_mask_t newMask) {
+   if (oldMask == newMask) {
+      return;
+   }
+   X11EventSelections::GetInstance().SelectXI2(window, m_deviceID, oldMask, newMask);
+   for (auto eventType: UTIL::XI2EventTypesFromMask(oldMask)) {
+      StopListeningFor(X11EventRoute::XI2(eventType, window, GetRouteDeviceID()));
+   }
+   for (auto eventType: UTIL::XI2EventTypesFromMask(newMask)) {
+      ListenFor(X11EventRoute::XI2(eventType, window, GetRouteDeviceID()));
+   }
+}
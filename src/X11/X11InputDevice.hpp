@@ -46,8 +46,9 @@ class NLSWIN_API_PRIVATE X11InputDevice : public X11RawInputDevice, virtual publ
     * to.
     *
     * Not necessary if you only need to subscribe to regular XCB events or raw events from the root
-    * window. */
+    * window. Replaces the mask this device selected on windows that have already been subscribed to. */
    void SubscribeToWindowSpecificXInput2Events(xcb_input_xi_event_mask_t eventMask);
+   ~X11InputDevice() override;
 
    protected:
    const std::unordered_map<xcb_window_t, std::weak_ptr<X11Window>> &GetSubscribedWindows() const noexcept {
@@ -55,6 +56,9 @@ class NLSWIN_API_PRIVATE X11InputDevice : public X11RawInputDevice, virtual publ
    }
 
    private:
+   /*! Replaces this device's XI2 events selected on a window, and the routes they are dispatched along. */
+   void SelectWindowXInput2Events(xcb_window_t window, xcb_input_xi_event_mask_t oldMask,
+                                  xcb_input_xi_event_mask_t newMask);
    xcb_input_xi_event_mask_t m_windowSpecificXInput2SubscribedEvents {(xcb_input_xi_event_mask_t)0};
    std::unordered_map<xcb_window_t, std::weak_ptr<X11Window>> m_subscribedWindows;
 };
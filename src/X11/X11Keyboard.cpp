@@ -19,14 +19,13 @@ using namespace NLSWIN;
 
 std::shared_ptr<Keyboard> Keyboard::Create() {
    xcb_input_device_id_t devID = xkb_x11_get_core_keyboard_device_id(XConnection::GetConnection());
-   std::shared_ptr<X11Keyboard> impl = std::make_shared<X11Keyboard>(KeyboardDeviceInfo {"", devID});
-   X11EventBus::GetInstance().RegisterListener(impl);
+   std::shared_ptr<X11Keyboard> impl =
+      X11EventBus::GetInstance().CreateListener<X11Keyboard>(KeyboardDeviceInfo {"", devID});
    return std::move(impl);
 }
 
 std::shared_ptr<Keyboard> Keyboard::Create(KeyboardDeviceInfo device) {
-   std::shared_ptr<X11Keyboard> impl = std::make_shared<X11Keyboard>(device);
-   X11EventBus::GetInstance().RegisterListener(impl);
+   std::shared_ptr<X11Keyboard> impl = X11EventBus::GetInstance().CreateListener<X11Keyboard>(device);
    return std::move(impl);
 }
 
@@ -37,19 +36,40 @@ std::vector<KeyboardDeviceInfo> Keyboard::EnumerateKeyboards() noexcept {
 X11Keyboard::X11Keyboard(KeyboardDeviceInfo info) {
    m_keyboardContext = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
    m_deviceID = info.platformSpecificIdentifier;
+   ConfigureQueue(256, QueueOverflowPolicy::GROW);
    m_keymap = xkb_x11_keymap_new_from_device(m_keyboardContext, XConnection::GetConnection(), m_deviceID,
                                              XKB_KEYMAP_COMPILE_NO_FLAGS);
    m_dummyState = xkb_state_new(m_keymap);
    m_realState = xkb_x11_state_new_from_device(m_keymap, XConnection::GetConnection(), m_deviceID);
-   SubscribeToWindowSpecificXInput2Events(m_inputEventMask);
+   SubscribeToWindowSpecificXInput2Events(InputEventMask());
 
    // Subscribe for events that notify us when keyboard state has changed (modifiers).
    xcb_xkb_select_events(XConnection::GetConnection(), m_deviceID, XCB_XKB_EVENT_TYPE_STATE_NOTIFY, 0,
                          XCB_XKB_EVENT_TYPE_STATE_NOTIFY, XCB_XKB_MAP_PART_MODIFIER_MAP,
                          XCB_XKB_MAP_PART_MODIFIER_MAP, nullptr);
+   ListenFor(X11EventRoute::Core(XConnection::GetXKBBaseEvent()));
    m_InternalKeyState.fill(false);
 }
 
+xcb_input_xi_event_mask_t X11Keyboard::InputEventMask() const noexcept {
+   if (!IsEventWanted<KeyEvent>() && !IsEventWanted<CharacterEvent>()) {
+      return (xcb_input_xi_event_mask_t)0;
+   }
+   return (xcb_input_xi_event_mask_t)(XCB_INPUT_XI_EVENT_MASK_KEY_PRESS |
+                                      XCB_INPUT_XI_EVENT_MASK_KEY_RELEASE);
+}
+
+void X11Keyboard::OnEventFilterChanged() {
+   xcb_input_xi_event_mask_t mask = InputEventMask();
+   if (mask == 0) {
+      // Releases stop arriving too, so a key held now would otherwise stay held, and its next press would be
+      // reported as a repeat.
+      std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
+      m_InternalKeyState.fill(false);
+   }
+   SubscribeToWindowSpecificXInput2Events(mask);
+}
+
 void X11Keyboard::ProcessGenericEvent(xcb_generic_event_t *event) {
    // Handle locked modifiers (capslock, numlock, etc) first.
    if ((event->response_type & ~0x80) ==
@@ -72,16 +92,14 @@ void X11Keyboard::ProcessGenericEvent(xcb_generic_event_t *event) {
          xcb_input_key_press_event_t *keyEvent =
             reinterpret_cast<xcb_input_key_press_event_t *>(genericEvent);
          if (GetSubscribedWindows().count(keyEvent->event)) {
-            if (m_deviceID == keyEvent->deviceid || m_deviceID == XCB_INPUT_DEVICE_ALL_MASTER) {
-               Event processedEvent = ProcessKeyEvent(genericEvent);
-               PushEvent(processedEvent);
-            }
+            KeyEvent processedEvent = ProcessKeyEvent(genericEvent);
+            PushEvent(processedEvent);
          }
       }
    }
 }
 
-Event X11Keyboard::ProcessKeyEvent(xcb_ge_generic_event_t *event) {
+KeyEvent X11Keyboard::ProcessKeyEvent(xcb_ge_generic_event_t *event) {
    KeyEvent keyEvent;
    switch (event->event_type) {
       case XCB_INPUT_KEY_PRESS: {
@@ -105,6 +123,9 @@ Event X11Keyboard::ProcessKeyEvent(xcb_ge_generic_event_t *event) {
             m_InternalKeyState[pressEvent->detail] = true;
          }
          // Handle CharacterEvents last.
+         if (!IsEventWanted<CharacterEvent>()) {
+            break;
+         }
          char character = (char)xkb_state_key_get_utf32(m_realState, pressEvent->detail);
          if (isprint(character)) {
             PushEvent(NLSWIN::CharacterEvent {
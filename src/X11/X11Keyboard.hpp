@@ -35,8 +35,11 @@ class NLSWIN_API_PRIVATE X11Keyboard : public X11InputDevice, public Keyboard {
 
    private:
    void ProcessGenericEvent(xcb_generic_event_t *event) override;
+   void OnEventFilterChanged() override;
+   /*! The XI2 events needed to generate the event types let through by the event filter. */
+   [[nodiscard]] xcb_input_xi_event_mask_t InputEventMask() const noexcept;
 
-   [[nodiscard]] Event ProcessKeyEvent(xcb_ge_generic_event_t *event);
+   [[nodiscard]] KeyEvent ProcessKeyEvent(xcb_ge_generic_event_t *event);
    [[nodiscard]] xkb_keysym_t GetSymFromKeyCode(unsigned int keycode);
    void UpdateLockedModifiers(xcb_xkb_state_notify_event_t *stateNotify);
    void UpdateDepressedModifiers(NLSWIN::KeyValue val, bool pressed);
@@ -57,9 +60,6 @@ class NLSWIN_API_PRIVATE X11Keyboard : public X11InputDevice, public Keyboard {
    xkb_state *m_realState {nullptr};
    KeyModifiers m_Mods {false};
 
-   const xcb_input_xi_event_mask_t m_inputEventMask {
-      (xcb_input_xi_event_mask_t)(XCB_INPUT_XI_EVENT_MASK_KEY_PRESS | XCB_INPUT_XI_EVENT_MASK_KEY_RELEASE)};
-
    std::unordered_map<unsigned int, NLSWIN::KeyValue> m_keyTranslationTable = {
       {XKB_KEY_0, NLSWIN::KeyValue::KEY_0},
       {XKB_KEY_1, NLSWIN::KeyValue::KEY_1},
@@ -0,0 +1,329 @@
+#include "X11MonitorCache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include "../Common/VideoModeOrder.hpp"
+#include "X11EventBus.hpp"
+#include "X11Util.hpp"
+#include "XConnection.h"
+
+using namespace NLSWIN;
+
+/*! The refresh rate of a mode, rounded to two decimal places. */
+static float RefreshRateOf(const xcb_randr_mode_info_t &mode) {
+   double vTotal = mode.vtotal;
+   // If doublescan is set, each scanline needs to be doubled, otherwise we end up with a refresh rate that is
+   // twice as high as it should be.
+   if (mode.mode_flags & XCB_RANDR_MODE_FLAG_DOUBLE_SCAN) {
+      vTotal *= 2;
+   }
+   if (mode.htotal == 0 || vTotal == 0) {
+      return 0.0f;
+   }
+   double refresh = mode.dot_clock / (mode.htotal * vTotal);
+   return static_cast<float>(std::round(refresh * 100.0) / 100.0);
+}
+
+X11MonitorCache &X11MonitorCache::GetInstance() {
+   static X11MonitorCache instance;
+   return instance;
+}
+
+X11MonitorCache::X11MonitorCache() {
+   const XExtensionVersion &randr = XConnection::GetCapabilities().randr;
+   m_hasMonitors = randr.present && (randr.major > 1 || randr.minor >= 5);
+   if (!m_hasMonitors) {
+      return;
+   }
+   xcb_connection_t *connection = XConnection::GetConnection();
+   m_baseEvent = xcb_get_extension_data(connection, &xcb_randr_id)->first_event;
+   xcb_randr_select_input(connection, XConnection::GetRootWindow(),
+                          XCB_RANDR_NOTIFY_MASK_SCREEN_CHANGE | XCB_RANDR_NOTIFY_MASK_CRTC_CHANGE |
+                             XCB_RANDR_NOTIFY_MASK_OUTPUT_CHANGE);
+   xcb_flush(connection);
+   X11EventBus::GetInstance().SetMonitorCache(this);
+}
+
+bool X11MonitorCache::IsNotifyEvent(uint8_t type) const noexcept {
+   return m_hasMonitors &&
+          (type == m_baseEvent + XCB_RANDR_SCREEN_CHANGE_NOTIFY || type == m_baseEvent + XCB_RANDR_NOTIFY);
+}
+
+std::vector<uint8_t> X11MonitorCache::GetNotifyEventTypes() const {
+   if (!m_hasMonitors) {
+      return {};
+   }
+   return {static_cast<uint8_t>(m_baseEvent + XCB_RANDR_SCREEN_CHANGE_NOTIFY),
+           static_cast<uint8_t>(m_baseEvent + XCB_RANDR_NOTIFY)};
+}
+
+void X11MonitorCache::OnNotify(const xcb_generic_event_t *event) noexcept {
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_stale = true;
+   xcb_timestamp_t time = 0;
+   // Only CRTC changes carry no configuration time. Their timestamp is the same as that of the other
+   // notifications of their burst.
+   xcb_timestamp_t configTime = m_lastNotifyConfigTime;
+   if ((event->response_type & ~0x80) == m_baseEvent + XCB_RANDR_SCREEN_CHANGE_NOTIFY) {
+      auto screenChange = reinterpret_cast<const xcb_randr_screen_change_notify_event_t *>(event);
+      time = screenChange->timestamp;
+      configTime = screenChange->config_timestamp;
+   } else {
+      auto notify = reinterpret_cast<const xcb_randr_notify_event_t *>(event);
+      if (notify->subCode == XCB_RANDR_NOTIFY_OUTPUT_CHANGE) {
+         time = notify->u.oc.timestamp;
+         configTime = notify->u.oc.config_timestamp;
+      } else if (notify->subCode == XCB_RANDR_NOTIFY_CRTC_CHANGE) {
+         time = notify->u.cc.timestamp;
+      } else {
+         return;
+      }
+   }
+   // Setting a mode changes the timestamp, and plugging in an output changes the configuration time.
+   if (time != m_lastNotifyTime || configTime != m_lastNotifyConfigTime) {
+      m_lastNotifyTime = time;
+      m_lastNotifyConfigTime = configTime;
+      m_generation++;
+   }
+}
+
+std::vector<X11Monitor> X11MonitorCache::GetMonitors() {
+   std::lock_guard<std::mutex> lock(m_mutex);
+   EnsureFresh();
+   return m_monitors;
+}
+
+std::optional<X11Monitor> X11MonitorCache::GetMonitorAt(Point position) {
+   std::lock_guard<std::mutex> lock(m_mutex);
+   EnsureFresh();
+   const X11Monitor *primary = nullptr;
+   for (const auto &monitor: m_monitors) {
+      Rect area {static_cast<int>(monitor.info.screenXCord), static_cast<int>(monitor.info.screenYCord),
+                 monitor.info.horzResolution, monitor.info.verticalResolution};
+      if (UTIL::IsPointInRect(area, position)) {
+         return monitor;
+      }
+      if (monitor.primary) {
+         primary = &monitor;
+      }
+   }
+   // The point is not within any monitor, so fall back to the primary monitor, or failing that the first.
+   if (primary) {
+      return *primary;
+   }
+   if (!m_monitors.empty()) {
+      return m_monitors.front();
+   }
+   return std::nullopt;
+}
+
+const VideoMode *X11MonitorCache::FindMode(const MonitorInfo &monitor, int width, int height,
+                                           float preferredRefreshRate) {
+   // Refresh rates sort in descending order, so the highest at this resolution comes first.
+   VideoMode key {width, height, std::numeric_limits<float>::max()};
+   auto first = std::lower_bound(monitor.modes.begin(), monitor.modes.end(), key, ModeOrder<VideoMode>);
+   if (first == monitor.modes.end() || first->horzResolution != width || first->vertResolution != height) {
+      return nullptr;
+   }
+   for (auto mode = first; mode != monitor.modes.end(); mode++) {
+      if (mode->horzResolution != width || mode->vertResolution != height) {
+         break;
+      }
+      if (mode->refreshRate == preferredRefreshRate) {
+         return &*mode;
+      }
+   }
+   return &*first;
+}
+
+const X11Monitor *X11MonitorCache::FindMonitor(xcb_randr_output_t output) const noexcept {
+   for (const auto &monitor: m_monitors) {
+      if (monitor.output == output) {
+         return &monitor;
+      }
+   }
+   return nullptr;
+}
+
+uint8_t X11MonitorCache::SendCrtcConfig(const CrtcConfig &config) {
+   xcb_connection_t *connection = XConnection::GetConnection();
+   auto cookie = xcb_randr_set_crtc_config(connection, config.crtc, XCB_CURRENT_TIME, m_configTimestamp,
+                                           config.x, config.y, config.mode, config.rotation,
+                                           config.outputs.size(), config.outputs.data());
+   xcb_randr_set_crtc_config_reply_t *reply = xcb_randr_set_crtc_config_reply(connection, cookie, nullptr);
+   if (!reply) {
+      return XCB_RANDR_SET_CONFIG_FAILED;
+   }
+   uint8_t status = reply->status;
+   free(reply);
+   return status;
+}
+
+bool X11MonitorCache::SetMode(xcb_randr_output_t output, xcb_randr_mode_t mode) {
+   std::lock_guard<std::mutex> lock(m_mutex);
+   EnsureFresh();
+   for (int attempt = 0; attempt < 2; attempt++) {
+      const X11Monitor *monitor = FindMonitor(output);
+      if (!monitor || monitor->crtc == 0) {
+         return false;
+      }
+      CrtcConfig current {monitor->crtc,  monitor->currentMode, monitor->crtcX,
+                          monitor->crtcY, monitor->rotation,    monitor->crtcOutputs};
+      CrtcConfig requested = current;
+      requested.mode = mode;
+      uint8_t status = SendCrtcConfig(requested);
+      if (status == XCB_RANDR_SET_CONFIG_SUCCESS) {
+         // Only the configuration from before the first switch is kept, so that restoring undoes them all.
+         m_savedConfigs.emplace(output, std::move(current));
+         // The notifications for this change will follow, but the cache is out of date already.
+         m_stale = true;
+         return true;
+      }
+      if (status != XCB_RANDR_SET_CONFIG_INVALID_CONFIG_TIME) {
+         return false;
+      }
+      // Someone else changed the configuration first, so retry against theirs.
+      Refresh();
+   }
+   return false;
+}
+
+bool X11MonitorCache::RestoreMode(xcb_randr_output_t output) {
+   std::lock_guard<std::mutex> lock(m_mutex);
+   auto saved = m_savedConfigs.find(output);
+   if (saved == m_savedConfigs.end()) {
+      return true;
+   }
+   EnsureFresh();
+   for (int attempt = 0; attempt < 2; attempt++) {
+      uint8_t status = SendCrtcConfig(saved->second);
+      if (status == XCB_RANDR_SET_CONFIG_SUCCESS) {
+         m_savedConfigs.erase(saved);
+         m_stale = true;
+         return true;
+      }
+      if (status != XCB_RANDR_SET_CONFIG_INVALID_CONFIG_TIME) {
+         return false;
+      }
+      Refresh();
+   }
+   return false;
+}
+
+void X11MonitorCache::EnsureFresh() {
+   if (m_stale) {
+      Refresh();
+   }
+}
+
+void X11MonitorCache::FillWithScreen() {
+   xcb_screen_t *screen = XConnection::GetDefaultScreen();
+   std::vector<X11Monitor> monitors;
+   monitors.push_back({{screen->width_in_pixels, screen->height_in_pixels, 0, 0, "screen", {}}, true});
+   m_monitors.swap(monitors);
+}
+
+void X11MonitorCache::Refresh() {
+   m_stale = false;
+   if (!m_hasMonitors) {
+      FillWithScreen();
+      return;
+   }
+   xcb_connection_t *connection = XConnection::GetConnection();
+   xcb_window_t root = XConnection::GetRootWindow();
+   auto resourcesCookie = xcb_randr_get_screen_resources_current(connection, root);
+   auto monitorsCookie = xcb_randr_get_monitors(connection, root, true);
+   xcb_randr_get_screen_resources_current_reply_t *resources =
+      xcb_randr_get_screen_resources_current_reply(connection, resourcesCookie, nullptr);
+   xcb_randr_get_monitors_reply_t *monitorsReply =
+      xcb_randr_get_monitors_reply(connection, monitorsCookie, nullptr);
+   if (!resources || !monitorsReply) {
+      free(resources);
+      free(monitorsReply);
+      FillWithScreen();
+      return;
+   }
+   m_configTimestamp = resources->config_timestamp;
+
+   // Every output and CRTC is asked about before waiting on any of the replies.
+   struct PendingMonitor {
+      xcb_randr_monitor_info_t *monitor;
+      xcb_randr_output_t output;
+      xcb_randr_get_output_info_cookie_t cookie;
+   };
+   std::vector<PendingMonitor> pendingMonitors;
+   for (auto iter = xcb_randr_get_monitors_monitors_iterator(monitorsReply); iter.rem > 0;
+        xcb_randr_monitor_info_next(&iter)) {
+      // A monitor made of several outputs is reported, and has its mode set, through its first output.
+      if (xcb_randr_monitor_info_outputs_length(iter.data) == 0) {
+         continue;
+      }
+      xcb_randr_output_t output = xcb_randr_monitor_info_outputs(iter.data)[0];
+      pendingMonitors.push_back(
+         {iter.data, output, xcb_randr_get_output_info(connection, output, m_configTimestamp)});
+   }
+   const xcb_randr_crtc_t *crtcs = xcb_randr_get_screen_resources_current_crtcs(resources);
+   int crtcCount = xcb_randr_get_screen_resources_current_crtcs_length(resources);
+   std::vector<xcb_randr_get_crtc_info_cookie_t> crtcCookies;
+   for (int i = 0; i < crtcCount; i++) {
+      crtcCookies.push_back(xcb_randr_get_crtc_info(connection, crtcs[i], m_configTimestamp));
+   }
+
+   std::unordered_map<xcb_randr_crtc_t, xcb_randr_get_crtc_info_reply_t *> crtcInfos;
+   for (int i = 0; i < crtcCount; i++) {
+      crtcInfos[crtcs[i]] = xcb_randr_get_crtc_info_reply(connection, crtcCookies[i], nullptr);
+   }
+   std::unordered_map<xcb_randr_mode_t, const xcb_randr_mode_info_t *> modeInfos;
+   const xcb_randr_mode_info_t *allModes = xcb_randr_get_screen_resources_current_modes(resources);
+   for (int i = 0; i < xcb_randr_get_screen_resources_current_modes_length(resources); i++) {
+      modeInfos[allModes[i].id] = &allModes[i];
+   }
+
+   std::vector<X11Monitor> monitors;
+   for (const auto &pending: pendingMonitors) {
+      xcb_randr_get_output_info_reply_t *outputInfo =
+         xcb_randr_get_output_info_reply(connection, pending.cookie, nullptr);
+      if (!outputInfo) {
+         continue;
+      }
+      std::vector<SortableMode> sortedModes;
+      const xcb_randr_mode_t *outputModes = xcb_randr_get_output_info_modes(outputInfo);
+      for (int i = 0; i < xcb_randr_get_output_info_modes_length(outputInfo); i++) {
+         auto modeInfo = modeInfos.find(outputModes[i]);
+         if (modeInfo != modeInfos.end()) {
+            const xcb_randr_mode_info_t &mode = *modeInfo->second;
+            sortedModes.push_back({mode.width, mode.height, RefreshRateOf(mode), mode.id});
+         }
+      }
+      // Sorted once here, so that looking up a mode by resolution is a binary search.
+      std::vector<VideoMode> modes = SortVideoModes(std::move(sortedModes));
+      std::string name(reinterpret_cast<const char *>(xcb_randr_get_output_info_name(outputInfo)),
+                       xcb_randr_get_output_info_name_length(outputInfo));
+      const xcb_randr_monitor_info_t *monitor = pending.monitor;
+      X11Monitor cached {{monitor->width, monitor->height, monitor->x, monitor->y, name, modes},
+                         static_cast<bool>(monitor->primary),
+                         pending.output};
+      auto crtcInfo = crtcInfos.find(outputInfo->crtc);
+      if (crtcInfo != crtcInfos.end() && crtcInfo->second) {
+         const xcb_randr_get_crtc_info_reply_t *crtc = crtcInfo->second;
+         cached.crtc = outputInfo->crtc;
+         cached.currentMode = crtc->mode;
+         cached.crtcX = crtc->x;
+         cached.crtcY = crtc->y;
+         cached.rotation = crtc->rotation;
+         const xcb_randr_output_t *crtcOutputs = xcb_randr_get_crtc_info_outputs(crtc);
+         cached.crtcOutputs.assign(crtcOutputs, crtcOutputs + xcb_randr_get_crtc_info_outputs_length(crtc));
+      }
+      monitors.push_back(std::move(cached));
+      free(outputInfo);
+   }
+
+   for (auto &[crtc, info]: crtcInfos) { free(info); }
+   free(monitorsReply);
+   free(resources);
+   m_monitors.swap(monitors);
+}
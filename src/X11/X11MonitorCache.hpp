@@ -0,0 +1,150 @@
+/*!
+ * @file
+ * @author MZelriche
+ * @date 2021-2022
+ * @copyright MIT License
+ *
+ * @addtogroup X11 Linux X11 API
+ * @brief Platform-specific X11 implementation of the API
+ */
+#pragma once
+
+#include <xcb/randr.h>
+#include <xcb/xcb.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "NamelessWindow/NLSAPI.hpp"
+#include "NamelessWindow/Window.hpp"
+
+namespace NLSWIN {
+
+/*!
+ * @brief A monitor, along with the RandR output and CRTC that drive it.
+ * @ingroup X11
+ */
+struct NLSWIN_API_PRIVATE X11Monitor {
+   /*! Its modes are sorted by resolution, and then from the highest refresh rate to the lowest. */
+   MonitorInfo info;
+   bool primary {false};
+   /*! The first output of the monitor. Only one output per monitor is currently supported. */
+   xcb_randr_output_t output {0};
+   /*! The CRTC driving the output, or 0 if the output is disabled. */
+   xcb_randr_crtc_t crtc {0};
+   xcb_randr_mode_t currentMode {0};
+   int16_t crtcX {0};
+   int16_t crtcY {0};
+   uint16_t rotation {0};
+   /*! Every output driven by the CRTC, all of which must be given again when its mode is changed. */
+   std::vector<xcb_randr_output_t> crtcOutputs;
+};
+
+/*!
+ * @brief Singleton cache of the monitors and video modes reported by RandR.
+ * @ingroup X11
+ *
+ * Filled with GetScreenResourcesCurrent, which reports the configuration the server already knows rather than
+ * probing the outputs for changes the way GetScreenResources can. All requests of a refresh are pipelined, so
+ * it costs two round trips however many monitors there are. The cache is only refreshed once RandR has
+ * reported that the configuration changed, and then only when the monitors are next asked for.
+ *
+ * Without RandR 1.5, which introduced monitors, the whole screen is reported as a single monitor.
+ */
+class NLSWIN_API_PRIVATE X11MonitorCache {
+   public:
+   /*! Singleton Accessor */
+   static X11MonitorCache &GetInstance();
+   /*! The cached monitors, refreshed first if RandR has reported a change since they were cached. */
+   std::vector<X11Monitor> GetMonitors();
+   /*! The monitor containing a point, or else the primary monitor, or nullopt if there are no monitors. */
+   std::optional<X11Monitor> GetMonitorAt(Point position);
+   /*!
+    * @brief Finds a mode of a monitor at a resolution, with a binary search of its sorted modes.
+    * @param preferredRefreshRate The refresh rate to pick if there is a choice. Otherwise the highest is.
+    * @returns The mode, or nullptr if the monitor has no mode at that resolution.
+    */
+   static const VideoMode *FindMode(const MonitorInfo &monitor, int width, int height,
+                                    float preferredRefreshRate);
+   /*!
+    * @brief Switches the CRTC driving an output to another mode.
+    *
+    * The configuration of the CRTC is saved by the first switch, so that RestoreMode can put it back. If the
+    * configuration changed since the cache was filled, the cache is refreshed and the change is tried once
+    * more against the new configuration.
+    * @returns False if the output no longer exists, is disabled, or the server refused the mode.
+    */
+   bool SetMode(xcb_randr_output_t output, xcb_randr_mode_t mode);
+   /*!
+    * @brief Puts back the configuration that the CRTC driving an output had before the first SetMode.
+    * @returns False if the server refused the saved configuration. True if nothing was changed to restore.
+    */
+   bool RestoreMode(xcb_randr_output_t output);
+   /*! Whether an X event type is a RandR notification, which the X11EventBus passes to OnNotify. */
+   [[nodiscard]] bool IsNotifyEvent(uint8_t type) const noexcept;
+   /*! The X event types of the RandR notifications, or nothing if the monitors never change. */
+   [[nodiscard]] std::vector<uint8_t> GetNotifyEventTypes() const;
+   /*!
+    * @brief Marks the cache as out of date after a RandR notification, and counts the change it reports.
+    *
+    * Every notification must be passed here, whether or not the cache has been refreshed since the last.
+    */
+   void OnNotify(const xcb_generic_event_t *event) noexcept;
+   /*!
+    * @brief Incremented for every change to the configuration that RandR reports.
+    *
+    * A single change produces a burst of notifications, which all carry the same timestamps, so it only
+    * increments the generation once. Comparing generations tells a new change apart from the rest of a burst
+    * already reported. Unlike the cache itself, it is kept up to date even if the monitors are never asked
+    * for.
+    */
+   [[nodiscard]] inline uint64_t GetGeneration() const noexcept { return m_generation; }
+
+   private:
+   /*! The configuration of a CRTC, as needed to set it. */
+   struct CrtcConfig {
+      xcb_randr_crtc_t crtc {0};
+      xcb_randr_mode_t mode {0};
+      int16_t x {0};
+      int16_t y {0};
+      uint16_t rotation {0};
+      std::vector<xcb_randr_output_t> outputs;
+   };
+   std::mutex m_mutex;
+   /*! The configurations to restore, keyed by the output they were changed for. */
+   std::unordered_map<xcb_randr_output_t, CrtcConfig> m_savedConfigs;
+   std::vector<X11Monitor> m_monitors;
+   /*! The configuration timestamp of the cached resources, which RandR requires when changing modes. */
+   xcb_timestamp_t m_configTimestamp {0};
+   /*! Whether the cache must be refilled before it is next read. Only affects when the cache is refilled. */
+   bool m_stale {true};
+   std::atomic<uint64_t> m_generation {0};
+   /*! The timestamps carried by the last notification, which identify the change it belongs to. */
+   xcb_timestamp_t m_lastNotifyTime {0};
+   xcb_timestamp_t m_lastNotifyConfigTime {0};
+   /*! Whether the server supports RandR 1.5, and so reports monitors. */
+   bool m_hasMonitors {false};
+   uint8_t m_baseEvent {0};
+   /*! Fills the cache from the server. Must be called with m_mutex held. */
+   void Refresh();
+   /*! Fills the cache with the whole screen as a single monitor. Must be called with m_mutex held. */
+   void FillWithScreen();
+   /*! Refreshes the cache if it is stale. Must be called with m_mutex held. */
+   void EnsureFresh();
+   /*!
+    * Applies a configuration to a CRTC, and waits for the server to answer. Must be called with m_mutex held.
+    * @returns The XCB_RANDR_SET_CONFIG status, or XCB_RANDR_SET_CONFIG_FAILED if there was no reply.
+    */
+   uint8_t SendCrtcConfig(const CrtcConfig &config);
+   /*! The cached monitor driven by an output, or nullptr. Must be called with m_mutex held. */
+   const X11Monitor *FindMonitor(xcb_randr_output_t output) const noexcept;
+   X11MonitorCache();
+   X11MonitorCache(X11MonitorCache const &) = delete;
+   void operator=(X11MonitorCache const &) = delete;
+};
+
+}  // namespace NLSWIN
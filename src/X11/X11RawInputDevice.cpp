@@ -1,15 +1,24 @@
 #include "X11RawInputDevice.hpp"
 
+#include "X11EventSelections.hpp"
 #include "X11Util.hpp"
 
 using namespace NLSWIN;
 
+X11RawInputDevice::~X11RawInputDevice() {
+   X11EventSelections::GetInstance().SelectXI2(XConnection::GetRootWindow(), m_deviceID, m_rawRootEventMask,
+                                               0);
+}
+
 void X11RawInputDevice::SubscribeToRawRootEvents(xcb_input_xi_event_mask_t masks) {
-   UTIL::XI2EventMask mask;
-   mask.header.deviceid = m_deviceID;
-   mask.header.mask_len = sizeof(mask.mask) / sizeof(uint32_t);
-   mask.mask = masks;
-   auto cookie = xcb_input_xi_select_events_checked(XConnection::GetConnection(), UTIL::GetRootWindow(), 1,
-                                                    &mask.header);
-   xcb_flush(XConnection::GetConnection());  // To ensure the X server definitely gets the request.
-}
\ No newline at end of file
+   X11EventSelections::GetInstance().SelectXI2(XConnection::GetRootWindow(), m_deviceID, m_rawRootEventMask,
+                                               masks);
+   // Drop the routes of events that this device no longer wants, even if another listener still selects them.
+   for (auto eventType: UTIL::XI2EventTypesFromMask(m_rawRootEventMask)) {
+      StopListeningFor(X11EventRoute::XI2(eventType, 0, GetRouteDeviceID()));
+   }
+   for (auto eventType: UTIL::XI2EventTypesFromMask(masks)) {
+      ListenFor(X11EventRoute::XI2(eventType, 0, GetRouteDeviceID()));
+   }
+   m_rawRootEventMask = masks;
+}
@@ -21,10 +21,23 @@ namespace NLSWIN {
 /*! @ingroup X11 */
 class NLSWIN_API_PRIVATE X11RawInputDevice : public X11EventListener {
    public:
+   /*!
+    * @brief Selects XI2 events from the root window for this device, replacing any this listener selected
+    * before. Events that other listeners select for the same device stay selected.
+    */
    void SubscribeToRawRootEvents(xcb_input_xi_event_mask_t masks);
+   ~X11RawInputDevice() override;
+   [[nodiscard]] bool IsInputDevice() const noexcept override { return true; }
 
    protected:
    xcb_input_device_id_t m_deviceID {0};
+   /*! The device ID that events must carry to be routed to this device. */
+   [[nodiscard]] xcb_input_device_id_t GetRouteDeviceID() const noexcept {
+      return m_deviceID == XCB_INPUT_DEVICE_ALL_MASTER ? XCB_INPUT_DEVICE_ALL : m_deviceID;
+   }
+
+   private:
+   xcb_input_xi_event_mask_t m_rawRootEventMask {(xcb_input_xi_event_mask_t)0};
 };
 
 /*! @ingroup X11 */
@@ -13,14 +13,30 @@ using namespace NLSWIN;
 }
 
 std::shared_ptr<RawMouse> RawMouse::Create(MouseDeviceInfo device) {
-   std::shared_ptr<X11RawMouse> impl = std::make_shared<X11RawMouse>(device);
-   X11EventBus::GetInstance().RegisterListener(impl);
+   std::shared_ptr<X11RawMouse> impl = X11EventBus::GetInstance().CreateListener<X11RawMouse>(device);
    return std::move(impl);
 }
 
 X11RawMouse::X11RawMouse(MouseDeviceInfo device) {
    m_deviceID = device.platformSpecificIdentifier;
-   SubscribeToRawRootEvents(m_rawInputEventMask);
+   // Raw motion arrives at the device's polling rate, which may be 1000Hz or more.
+   ConfigureQueue(1024, QueueOverflowPolicy::GROW);
+   SubscribeToRawRootEvents(RawInputEventMask());
+}
+
+xcb_input_xi_event_mask_t X11RawMouse::RawInputEventMask() const noexcept {
+   uint32_t mask = 0;
+   if (IsEventWanted<RawMouseButtonEvent>() || IsEventWanted<RawMouseScrollEvent>()) {
+      mask |= XCB_INPUT_XI_EVENT_MASK_RAW_BUTTON_PRESS | XCB_INPUT_XI_EVENT_MASK_RAW_BUTTON_RELEASE;
+   }
+   if (IsEventWanted<RawMouseDeltaMovementEvent>()) {
+      mask |= XCB_INPUT_XI_EVENT_MASK_RAW_MOTION;
+   }
+   return (xcb_input_xi_event_mask_t)mask;
+}
+
+void X11RawMouse::OnEventFilterChanged() {
+   SubscribeToRawRootEvents(RawInputEventMask());
 }
 
 Event X11RawMouse::PackageNewRawButtonPressEvent(xcb_input_button_press_event_t *event) {
@@ -56,24 +72,20 @@ void X11RawMouse::ProcessGenericEvent(xcb_generic_event_t *event) {
       case XCB_INPUT_RAW_BUTTON_PRESS: {
          xcb_input_button_press_event_t *buttonPressEvent =
             reinterpret_cast<xcb_input_button_press_event_t *>(genericEvent);
-         if (buttonPressEvent->deviceid == m_deviceID) {
-            PushEvent(PackageNewRawButtonPressEvent(buttonPressEvent));
-         }
+         PushEvent(PackageNewRawButtonPressEvent(buttonPressEvent));
          break;
       }
       case XCB_INPUT_RAW_BUTTON_RELEASE: {
          xcb_input_button_release_event_t *buttonReleaseEvent =
             reinterpret_cast<xcb_input_button_release_event_t *>(genericEvent);
-         if (buttonReleaseEvent->deviceid == m_deviceID) {
-            PushEvent(PackageNewRawButtonReleaseEvent(buttonReleaseEvent));
-         }
+         PushEvent(PackageNewRawButtonReleaseEvent(buttonReleaseEvent));
          break;
       }
       case XCB_INPUT_RAW_MOTION: {
          xcb_input_raw_motion_event_t *rawEvent =
             reinterpret_cast<xcb_input_raw_motion_event_t *>(genericEvent);
-         if (rawEvent->deviceid == m_deviceID) {
-            PushEvent(PackageNewDeltaEvents(rawEvent));
+         if (auto deltaEvent = PackageNewDeltaEvents(rawEvent)) {
+            PushEvent(*deltaEvent);
          }
          break;
       }
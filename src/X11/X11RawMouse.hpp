@@ -27,10 +27,9 @@ class NLSWIN_API_PRIVATE X11RawMouse : public X11GenericMouse, public X11RawInpu
    Event PackageNewRawButtonPressEvent(xcb_input_button_press_event_t *event);
    Event PackageNewRawButtonReleaseEvent(xcb_input_button_press_event_t *event);
    void ProcessGenericEvent(xcb_generic_event_t *event) override;
-   const xcb_input_xi_event_mask_t m_rawInputEventMask {
-      (xcb_input_xi_event_mask_t)(XCB_INPUT_XI_EVENT_MASK_RAW_BUTTON_PRESS |
-                                  XCB_INPUT_XI_EVENT_MASK_RAW_BUTTON_RELEASE |
-                                  XCB_INPUT_XI_EVENT_MASK_RAW_MOTION)};
+   void OnEventFilterChanged() override;
+   /*! The raw XI2 events needed to generate the event types let through by the event filter. */
+   [[nodiscard]] xcb_input_xi_event_mask_t RawInputEventMask() const noexcept;
 };
 
 }  // namespace NLSWIN
\ No newline at end of file
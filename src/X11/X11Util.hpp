@@ -12,7 +12,7 @@
 #include <xcb/xcb.h>
 #include <xcb/xinput.h>
 #include <string>
-#include <X11/extensions/Xrandr.h>
+#include <vector>
 
 #include "NamelessWindow/NLSAPI.hpp"
 #include "NamelessWindow/Window.hpp"
@@ -24,37 +24,6 @@ struct NLSWIN_API_PRIVATE XI2EventMask {
    xcb_input_xi_event_mask_t mask;
 };
 
-/**
- * @brief Gets the default X screen.
- * @ingroup X11
- * @return The default X screen.
- */
-xcb_screen_t *GetDefaultScreen();
-
-/**
- * @brief Gets the default X screen number.
- * @ingroup X11
- * @return The default X screen number.
- */
-int GetDefaultScreenNumber();
-
-/**
- * @brief Gets the root window of the default screen.
- * @ingroup X11
- * @return The root window.
- */
-xcb_window_t GetRootWindow();
-
-/**
- * @brief Gets the monitor info struct whose area the top-right corner of a given window falls within.
- * If the given window does not fall within any monitor area, this function will return the primary monitor.
- * @ingroup X11
- * @param topRightWindowPos The x,y coordinate of the top-right corner of the window.
- * @param window The X11 ID for the window.
- * @return X11 Info struct about the monitor. 
- */
-XRRMonitorInfo *GetCurrentMonitor(xcb_window_t window, Point topRightWindowPos);
-
 /**
  * @brief Determines if an x,y point lies within a rectangle.
  * @ingroup X11
@@ -64,4 +33,12 @@ XRRMonitorInfo *GetCurrentMonitor(xcb_window_t window, Point topRightWindowPos);
  */
 bool IsPointInRect(Rect rectangle, Point position);
 
+/**
+ * @brief Expands an XInput2 event mask into the list of XI2 event types it selects.
+ * @ingroup X11
+ * @param mask The XI2 event mask.
+ * @return The XI2 event types (eg, XCB_INPUT_KEY_PRESS) whose bits are set in the mask.
+ */
+std::vector<uint16_t> XI2EventTypesFromMask(xcb_input_xi_event_mask_t mask);
+
 }  // namespace NLSWIN::UTIL
\ No newline at end of file
@@ -3,10 +3,7 @@
 #include <X11/X.h>
 #include <X11/Xatom.h>
 #include <X11/Xlib.h>
-#include <X11/extensions/Xrandr.h>
-#include <X11/extensions/randr.h>
 #include <math.h>
-#include <xcb/randr.h>
 #include <xcb/xcb.h>
 #include <xcb/xcb_icccm.h>
 #include <xcb/xproto.h>
@@ -14,35 +11,39 @@
 #include <cmath>
 #include <array>
 #include <cstring>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
-#include <unordered_set>
 
 #include "NamelessWindow/Exceptions.hpp"
 #include "NamelessWindow/Window.hpp"
 #include "X11EventBus.hpp"
+#include "X11EventSelections.hpp"
+#include "X11MonitorCache.hpp"
 #include "X11Util.hpp"
 #include "XConnection.h"
 
 using namespace NLSWIN;
 
 std::unordered_map<xcb_window_t, WindowID> X11Window::m_handleMap;
+uint32_t X11Window::m_pointerEventMask =
+   XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE | XCB_EVENT_MASK_POINTER_MOTION;
 
 std::shared_ptr<NLSWIN::Window> NLSWIN::Window::Create() {
-   std::shared_ptr<X11Window> impl = std::make_shared<X11Window>(WindowProperties());
-   X11EventBus::GetInstance().RegisterListener(impl);
+   std::shared_ptr<X11Window> impl = X11EventBus::GetInstance().CreateListener<X11Window>(WindowProperties());
    return std::move(impl);
 }
 
 std::shared_ptr<NLSWIN::Window> NLSWIN::Window::Create(WindowProperties properties) {
-   std::shared_ptr<X11Window> impl = std::make_shared<X11Window>(properties);
-   X11EventBus::GetInstance().RegisterListener(impl);
+   std::shared_ptr<X11Window> impl = X11EventBus::GetInstance().CreateListener<X11Window>(properties);
    return std::move(impl);
 }
 
 X11Window::X11Window(WindowProperties properties) {
    // Currently, this library doesn't support multiple screens.
-   m_defaultScreen = UTIL::GetDefaultScreen();
+   m_defaultScreen = XConnection::GetDefaultScreen();
    if (!m_defaultScreen) {
       throw PlatformInitializationException();
    }
@@ -73,19 +74,20 @@ X11Window::X11Window(WindowProperties properties) {
    xcb_create_colormap(XConnection::GetConnection(), XCB_COLORMAP_ALLOC_NONE, colormap, m_rootWindow,
                        m_selectedVisual);
    m_x11WindowID = xcb_generate_id(XConnection::GetConnection());
-   std::array<uint32_t, 3> valueMaskArray;
-   valueMaskArray[0] = m_eventMask;
-   valueMaskArray[1] = colormap;
-   valueMaskArray[2] = None;
+   std::array<uint32_t, 2> valueMaskArray;
+   valueMaskArray[0] = colormap;
+   valueMaskArray[1] = None;
    auto cookie =
       xcb_create_window_checked(XConnection::GetConnection(), m_visualDepth, m_x11WindowID, m_rootWindow,
                                 m_preferredXCoord, m_preferredYCoord, m_preferredWidth, m_preferredHeight,
                                 m_preferredBorderWidth, XCB_WINDOW_CLASS_INPUT_OUTPUT, m_selectedVisual,
-                                XCB_CW_EVENT_MASK | XCB_CW_COLORMAP, valueMaskArray.data());
+                                XCB_CW_COLORMAP, valueMaskArray.data());
    auto err = xcb_request_check(XConnection::GetConnection(), cookie);
    if (err) {
       throw PlatformInitializationException();
    }
+   // The core events are selected before the window is mapped, so none of its events can be missed.
+   X11EventSelections::GetInstance().SelectCore(m_x11WindowID, 0, WINDOW_EVENT_MASK);
 
    // Set window name if we were given one.
    if (!properties.windowName.empty()) {
@@ -95,29 +97,36 @@ X11Window::X11Window(WindowProperties properties) {
    }
 
    // Redirect window close events to the application.
-   xcb_intern_atom_cookie_t protocolsCookie =
-      xcb_intern_atom(XConnection::GetConnection(), false, std::strlen("WM_PROTOCOLS"), "WM_PROTOCOLS");
-   xcb_intern_atom_cookie_t deleteWindowCookie = xcb_intern_atom(
-      XConnection::GetConnection(), false, std::strlen("WM_DELETE_WINDOW"), "WM_DELETE_WINDOW");
-   xcb_intern_atom_reply_t *protocolsAtomReply =
-      xcb_intern_atom_reply(XConnection::GetConnection(), protocolsCookie, nullptr);
-   xcb_intern_atom_reply_t *deleteWindowAtomReply =
-      xcb_intern_atom_reply(XConnection::GetConnection(), deleteWindowCookie, nullptr);
+   xcb_atom_t deleteWindowAtom = XConnection::GetAtom(XAtom::WM_DELETE_WINDOW);
    xcb_change_property(XConnection::GetConnection(), XCB_PROP_MODE_REPLACE, m_x11WindowID,
-                       protocolsAtomReply->atom, XCB_ATOM_ATOM, 32, 1, &(deleteWindowAtomReply->atom));
-   free(protocolsAtomReply);
-   free(deleteWindowAtomReply);
+                       XConnection::GetAtom(XAtom::WM_PROTOCOLS), XCB_ATOM_ATOM, 32, 1, &deleteWindowAtom);
 
    // Prep a fullscreen toggle for when we are first mapped.
    if (properties.mode == WindowMode::FULLSCREEN) {
       m_firstMapCachedMode = WindowMode::FULLSCREEN;
    }
 
-   m_windowGeometry = GetNewGeometry();
+   // Until the window manager says otherwise, the window is a child of the root window where we put it.
+   m_parentWindow = m_rootWindow;
+   m_windowGeometry = {static_cast<int>(m_preferredXCoord), static_cast<int>(m_preferredYCoord),
+                       static_cast<int>(m_preferredWidth), static_cast<int>(m_preferredHeight)};
+   m_parentOffset = {m_windowGeometry.x, m_windowGeometry.y};
    xcb_flush(XConnection::GetConnection());
    NewID();
 
+   for (auto eventType: {XCB_PROPERTY_NOTIFY, XCB_CONFIGURE_NOTIFY, XCB_REPARENT_NOTIFY, XCB_FOCUS_IN,
+                         XCB_MAP_NOTIFY, XCB_UNMAP_NOTIFY, XCB_CLIENT_MESSAGE}) {
+      ListenFor(X11EventRoute::Core(eventType, m_x11WindowID));
+   }
+   // RandR notifications are selected on the root window by the monitor cache, and every window reports them.
+   X11MonitorCache &monitors = X11MonitorCache::GetInstance();
+   for (auto eventType: monitors.GetNotifyEventTypes()) { ListenFor(X11EventRoute::Core(eventType)); }
+   m_monitorGeneration = monitors.GetGeneration();
+
+   // The handle map is read while translating input, which may be happening on the input thread.
+   std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
    m_handleMap.insert({m_x11WindowID, GetGenericID()});
+   X11EventSelections::GetInstance().SelectCore(m_x11WindowID, 0, m_pointerEventMask);
 }
 
 xcb_visualid_t X11Window::SelectAppropriateVisualIDForGL(std::optional<GLConfiguration> config) {
@@ -128,7 +137,7 @@ xcb_visualid_t X11Window::SelectAppropriateVisualIDForGL(std::optional<GLConfigu
       SetVisualAttributeProperty(GLX_GREEN_SIZE, config.value().greenBitSize);
    }
    int numItems = 0;
-   GLXFBConfig *configs = glXChooseFBConfig(XConnection::GetDisplay(), UTIL::GetDefaultScreenNumber(),
+   GLXFBConfig *configs = glXChooseFBConfig(XConnection::GetDisplay(), XConnection::GetDefaultScreenNumber(),
                                             m_visualAttributesList.data(), &numItems);
    if (!configs) {
       return 0;
@@ -136,9 +145,12 @@ xcb_visualid_t X11Window::SelectAppropriateVisualIDForGL(std::optional<GLConfigu
    // All the returned FBConfigs match our criteria, just grab the first one and get the associated id
    glXGetFBConfigAttrib(XConnection::GetDisplay(), configs[0], GLX_VISUAL_ID, &m_selectedVisual);
    if (!m_selectedVisual) {
+      XFree(configs);
       return 0;
    }
    glXGetFBConfigAttrib(XConnection::GetDisplay(), configs[0], GLX_DEPTH_SIZE, &m_visualDepth);
+   // The configs themselves belong to the display, and outlive the array that lists them.
+   m_selectedConfig = configs[0];
    XFree(configs);
    return m_selectedVisual;
 }
@@ -151,26 +163,78 @@ void X11Window::SetVisualAttributeProperty(int property, int value) {
    }
 }
 
+void X11Window::SetPointerEventMask(xcb_event_mask_t mask) {
+   std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
+   if (m_pointerEventMask == mask) {
+      return;
+   }
+   for (const auto &[handle, id]: m_handleMap) {
+      X11EventSelections::GetInstance().SelectCore(handle, m_pointerEventMask, mask);
+   }
+   m_pointerEventMask = mask;
+}
+
 X11Window::~X11Window() {
+   RestoreVideoMode();
    xcb_destroy_window(XConnection::GetConnection(), m_x11WindowID);
    xcb_flush(XConnection::GetConnection());
+   std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
    m_handleMap.erase(m_x11WindowID);
+   X11EventSelections::GetInstance().Forget(m_x11WindowID);
 }
 
 void X11Window::Show() {
-   xcb_map_window(XConnection::GetConnection(), m_x11WindowID);
-   free(xcb_get_input_focus_reply(XConnection::GetConnection(),
-                                  xcb_get_input_focus(XConnection::GetConnection()), NULL));
-   // Block until we've actually been mapped.
-   while (!m_isMapped) { X11EventBus::GetInstance().PollEvents(); }
+   WaitForVisibility(ShowAsync());
+}
 
+void X11Window::Hide() {
+   WaitForVisibility(HideAsync());
+}
+
+std::shared_future<void> X11Window::ShowAsync() {
+   // The request is completed while dispatching, which may be happening on another thread.
+   std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
+   xcb_map_window(XConnection::GetConnection(), m_x11WindowID);
    xcb_flush(XConnection::GetConnection());
+   // An unmap that is still in flight will be followed by a MapNotify for this request.
+   if (m_isMapped && !m_hideRequest.IsPending()) {
+      return VisibilityRequest::Completed();
+   }
+   return m_showRequest.Begin();
 }
-void X11Window::Hide() {
+
+std::shared_future<void> X11Window::HideAsync() {
+   std::lock_guard<std::recursive_mutex> lock(X11EventBus::GetInstance().GetDispatchMutex());
    xcb_unmap_window(XConnection::GetConnection(), m_x11WindowID);
-   free(xcb_get_input_focus_reply(XConnection::GetConnection(),
-                                  xcb_get_input_focus(XConnection::GetConnection()), NULL));
-   while (m_isMapped) { X11EventBus::GetInstance().PollEvents(); }
+   xcb_flush(XConnection::GetConnection());
+   if (!m_isMapped && !m_showRequest.IsPending()) {
+      return VisibilityRequest::Completed();
+   }
+   return m_hideRequest.Begin();
+}
+
+void X11Window::WaitForVisibility(const std::shared_future<void> &request) {
+   auto isVisibilityEvent = [this](const xcb_generic_event_t *event) {
+      switch (event->response_type & ~0x80) {
+         case XCB_MAP_NOTIFY:
+            return reinterpret_cast<const xcb_map_notify_event_t *>(event)->window == m_x11WindowID;
+         case XCB_UNMAP_NOTIFY:
+            return reinterpret_cast<const xcb_unmap_notify_event_t *>(event)->window == m_x11WindowID;
+         default:
+            return false;
+      }
+   };
+   auto deadline = std::chrono::steady_clock::now() + VISIBILITY_TIMEOUT;
+   while (request.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      auto remaining =
+         std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+      if (remaining.count() <= 0) {
+         break;
+      }
+      // A MapNotify or UnmapNotify that does not complete the request, because it was for an earlier
+      // request still in flight, keeps the wait going.
+      X11EventBus::GetInstance().WaitForEvent(isVisibilityEvent, static_cast<int>(remaining.count()));
+   }
 }
 
 void X11Window::SetFullscreen() {
@@ -187,6 +251,11 @@ void X11Window::SetWindowed() noexcept {
    }
    ToggleFullscreen();
    m_windowMode = WindowMode::WINDOWED;
+   try {
+      RestoreVideoMode();
+   } catch (const std::exception &) {
+      // The saved mode is kept, so RestoreVideoMode() or the destructor can try again.
+   }
 }
 
 void X11Window::Reposition(uint32_t newX, uint32_t newY) noexcept {
@@ -199,78 +268,58 @@ void X11Window::Reposition(uint32_t newX, uint32_t newY) noexcept {
 }
 
 void X11Window::SetVideoMode(uint32_t width, uint32_t height) {
-   std::vector<MonitorInfo> infoVector = EnumerateMonitors();
-   XRRMonitorInfo *currentMonitor =
-      UTIL::GetCurrentMonitor(m_x11WindowID, {m_windowGeometry.x, m_windowGeometry.y});
-
-   XRRScreenResources *resources = XRRGetScreenResources(XConnection::GetDisplay(), m_x11WindowID);
-   // TODO: Currently only assuming one output per monitor. Could be problematic?
-   XRROutputInfo *info = XRRGetOutputInfo(XConnection::GetDisplay(), resources, currentMonitor->outputs[0]);
-   XRRCrtcInfo *crtcInfo = XRRGetCrtcInfo(XConnection::GetDisplay(), resources, info->crtc);
-
-   // Get the current modeinfo
-   XRRModeInfo *currentModeInfo = nullptr;
-   for (int i = 0; i < resources->nmode; i++) {
-      if (crtcInfo->mode == resources->modes[i].id) {
-         currentModeInfo = &resources->modes[i];
-         break;
-      }
+   std::optional<X11Monitor> monitor =
+      X11MonitorCache::GetInstance().GetMonitorAt({m_windowGeometry.x, m_windowGeometry.y});
+   if (!monitor) {
+      throw InvalidVideoModeException();
    }
-
-   // We need a list of valid modes and their refresh rates to find a suitable RRMode.
-   std::unordered_map<RRMode, float> validModes;
-   for (auto monitor: infoVector) {
-      if (std::strcmp(monitor.name.c_str(), info->name) == 0) {
-         for (auto mode: monitor.modes) {
-            validModes.insert({mode.platformSpecificIdentifier, mode.refreshRate});
-         }
+   float currentRefreshRate = 0.0f;
+   for (const auto &mode: monitor->info.modes) {
+      if (mode.platformSpecificIdentifier == monitor->currentMode) {
+         currentRefreshRate = mode.refreshRate;
       }
    }
+   const VideoMode *selectedMode = X11MonitorCache::FindMode(monitor->info, static_cast<int>(width),
+                                                             static_cast<int>(height), currentRefreshRate);
+   if (!selectedMode) {
+      // We couldn't find a matching resolution anywhere
+      throw InvalidVideoModeException();
+   }
+   SetVideoMode(*selectedMode);
+}
 
-   XRRModeInfo *exactMatch = nullptr;
-   RRMode highestRefreshRate = 0;
-   XRRModeInfo *highestRefreshRateMode = nullptr;
-   for (int i = 0; i < resources->nmode; i++) {
-      XRRModeInfo modeInfo = resources->modes[i];
-      // Calculate refresh rate of the queried mode.
-      float refresh = (float)modeInfo.dotClock / (modeInfo.hTotal * modeInfo.vTotal);
-      float truncatedRefresh = std::round(refresh * 100.0) / 100.0;
-
-      if (validModes.count(modeInfo.id) && modeInfo.height == height && modeInfo.width == width &&
-          validModes[modeInfo.id] == truncatedRefresh) {
-         // The user-requested resolution has a mode with the same refresh rate as now, we've found a perfect
-         // match.
-         exactMatch = &modeInfo;
-         break;
-      } else if (validModes.count(modeInfo.id) && modeInfo.height == height && modeInfo.width == width &&
-                 truncatedRefresh > highestRefreshRate) {
-         // We found a mode with a matching resolution, but it will require changing the refresh rate, so it
-         // is not preferable.
-         highestRefreshRate = truncatedRefresh;
-         highestRefreshRateMode = &modeInfo;
+void X11Window::SetVideoMode(const VideoMode &mode) {
+   X11MonitorCache &monitors = X11MonitorCache::GetInstance();
+   std::optional<X11Monitor> monitor = monitors.GetMonitorAt({m_windowGeometry.x, m_windowGeometry.y});
+   if (!monitor) {
+      throw InvalidVideoModeException();
+   }
+   // Mode IDs are shared by every output that supports the mode, but check that this one does.
+   const VideoMode *selectedMode = X11MonitorCache::FindMode(monitor->info, mode.horzResolution,
+                                                             mode.vertResolution, mode.refreshRate);
+   for (const auto &candidate: monitor->info.modes) {
+      if (candidate.platformSpecificIdentifier == mode.platformSpecificIdentifier) {
+         selectedMode = &candidate;
       }
    }
-
-   XRRModeInfo *finalRRMode = nullptr;
-   if (exactMatch) {
-      finalRRMode = exactMatch;
-   } else if (highestRefreshRateMode) {
-      finalRRMode = highestRefreshRateMode;
+   if (!selectedMode || !monitors.SetMode(monitor->output, selectedMode->platformSpecificIdentifier)) {
+      throw InvalidVideoModeException();
    }
+   // The window may have moved to another monitor since it last changed one.
+   if (m_videoModeOutput != 0 && m_videoModeOutput != monitor->output) {
+      monitors.RestoreMode(m_videoModeOutput);
+   }
+   m_videoModeOutput = monitor->output;
+}
 
-   if (finalRRMode) {
-      // Actually apply the new video mode.
-      XRRSetCrtcConfig(XConnection::GetDisplay(), resources, info->crtc, CurrentTime, crtcInfo->x,
-                       crtcInfo->y, finalRRMode->id, crtcInfo->rotation, crtcInfo->outputs,
-                       crtcInfo->noutput);
-      XFlush(XConnection::GetDisplay());
-   } else {
-      // We could find a matching resolution anywhere
-      throw InvalidVideoModeException();
+void X11Window::RestoreVideoMode() {
+   if (m_videoModeOutput != 0 && X11MonitorCache::GetInstance().RestoreMode(m_videoModeOutput)) {
+      m_videoModeOutput = 0;
    }
 }
 
-void X11Window::Resize(uint32_t width, uint32_t height) noexcept {
+void X11Window::Resize(uint32_t width, uint32_t height) {
+   // Throws before anything has changed, if the monitor has no mode at that resolution.
    if (m_windowMode == WindowMode::FULLSCREEN) {
       SetVideoMode(width, height);
    }
@@ -284,21 +333,11 @@ void X11Window::Resize(uint32_t width, uint32_t height) noexcept {
 }
 
 void X11Window::ToggleFullscreen() noexcept {
-   xcb_intern_atom_cookie_t stateCookie =
-      xcb_intern_atom(XConnection::GetConnection(), 1, std::strlen("_NET_WM_STATE"), "_NET_WM_STATE");
-   xcb_intern_atom_cookie_t fullscreenCookie = xcb_intern_atom(
-      XConnection::GetConnection(), 1, std::strlen("_NET_WM_STATE_FULLSCREEN"), "_NET_WM_STATE_FULLSCREEN");
-
    xcb_client_message_event_t message {0};
    message.response_type = XCB_CLIENT_MESSAGE;
 
-   xcb_intern_atom_reply_t *stateReply =
-      xcb_intern_atom_reply(XConnection::GetConnection(), stateCookie, nullptr);
-   xcb_intern_atom_reply_t *fullscreenReply =
-      xcb_intern_atom_reply(XConnection::GetConnection(), fullscreenCookie, nullptr);
-
-   xcb_atom_t stateAtom = stateReply->atom;
-   xcb_atom_t fullscreenAtom = fullscreenReply->atom;
+   xcb_atom_t stateAtom = XConnection::GetAtom(XAtom::NET_WM_STATE);
+   xcb_atom_t fullscreenAtom = XConnection::GetAtom(XAtom::NET_WM_STATE_FULLSCREEN);
 
    message.window = m_x11WindowID;
    message.type = stateAtom;
@@ -309,7 +348,7 @@ void X11Window::ToggleFullscreen() noexcept {
    message.data.data32[3] = 1;  // App event
    message.data.data32[4] = 0;  // Unused?
 
-   xcb_send_event(XConnection::GetConnection(), false, UTIL::GetRootWindow(),
+   xcb_send_event(XConnection::GetConnection(), false, m_rootWindow,
                   XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY | XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT,
                   (const char *)&message);
    xcb_flush(XConnection::GetConnection());
@@ -324,38 +363,33 @@ void X11Window::ProcessGenericEvent(xcb_generic_event_t *event) {
    switch (event->response_type & ~0x80) {
       case XCB_PROPERTY_NOTIFY: {
          // Update decoration sizes.
-         xcb_intern_atom_cookie_t frameCookie =
-            xcb_intern_atom(XConnection::GetConnection(), 1, std::strlen("_NET_FRAME_EXTENTS"), "_NET_FRAME_EXTENTS");
-         xcb_intern_atom_reply_t *frameReply =
-            xcb_intern_atom_reply(XConnection::GetConnection(), frameCookie, nullptr);
          xcb_property_notify_event_t *propEvent = reinterpret_cast<xcb_property_notify_event_t*>(event);
-
-         if (propEvent->atom == frameReply->atom) {
-            auto grub = xcb_get_property(XConnection::GetConnection(), 0, m_x11WindowID, frameReply->atom, XCB_ATOM_CARDINAL, 0, 4);
+         xcb_atom_t frameAtom = XConnection::GetAtom(XAtom::NET_FRAME_EXTENTS);
+         if (propEvent->atom == frameAtom) {
+            auto grub = xcb_get_property(XConnection::GetConnection(), 0, m_x11WindowID, frameAtom,
+                                         XCB_ATOM_CARDINAL, 0, 4);
             auto reply = xcb_get_property_reply(XConnection::GetConnection(), grub, nullptr);
-            int32_t *data = (int32_t*)xcb_get_property_value(reply);
-            m_decoDimensions = {data[0], data[1], data[2], data[3]};
-            Reposition(m_preferredXCoord, m_preferredYCoord);
+            if (reply && xcb_get_property_value_length(reply) >= 4 * (int)sizeof(int32_t)) {
+               int32_t *data = (int32_t*)xcb_get_property_value(reply);
+               m_decoDimensions = {data[0], data[1], data[2], data[3]};
+               Reposition(m_preferredXCoord, m_preferredYCoord);
+            }
+            free(reply);
          }
          break;
       }
       case XCB_CONFIGURE_NOTIFY: {
          xcb_configure_notify_event_t *notifyEvent = reinterpret_cast<xcb_configure_notify_event_t *>(event);
          if (notifyEvent->window == m_x11WindowID) {
-            // Has the window size changed?
-            if (notifyEvent->width != m_windowGeometry.width ||
-                notifyEvent->height != m_windowGeometry.height) {
-               WindowResizeEvent resizeEvent;
-               resizeEvent.newWidth = notifyEvent->width;
-               resizeEvent.newHeight = notifyEvent->height;
-               resizeEvent.sourceWindow = GetGenericID();
-               PushEvent(resizeEvent);
-               // Set new geometry
-               m_windowGeometry = GetNewGeometry();
-            }
-            if (notifyEvent->x != m_windowGeometry.x || notifyEvent->y != m_windowGeometry.y) {
-               m_windowGeometry = GetNewGeometry();
-            }
+            // The top bit of the response type marks events sent with SendEvent.
+            UpdateGeometry(notifyEvent, event->response_type & 0x80);
+         }
+         break;
+      }
+      case XCB_REPARENT_NOTIFY: {
+         xcb_reparent_notify_event_t *reparentEvent = reinterpret_cast<xcb_reparent_notify_event_t *>(event);
+         if (reparentEvent->window == m_x11WindowID) {
+            UpdateParent(reparentEvent);
          }
          break;
       }
@@ -370,6 +404,7 @@ void X11Window::ProcessGenericEvent(xcb_generic_event_t *event) {
       }
       case XCB_MAP_NOTIFY: {
          m_isMapped = true;
+         m_showRequest.Complete();
          if (m_firstMapCachedMode == WindowMode::FULLSCREEN) {
             ToggleFullscreen();
             m_windowMode = WindowMode::FULLSCREEN;
@@ -379,6 +414,7 @@ void X11Window::ProcessGenericEvent(xcb_generic_event_t *event) {
       }
       case XCB_UNMAP_NOTIFY: {
          m_isMapped = false;
+         m_hideRequest.Complete();
          break;
       }
       case XCB_CLIENT_MESSAGE: {
@@ -386,19 +422,28 @@ void X11Window::ProcessGenericEvent(xcb_generic_event_t *event) {
          // a close event directly. The close event is not sent to the API user, it is only handled
          // internally.
          xcb_client_message_event_t *clientEvent = reinterpret_cast<xcb_client_message_event_t *>(event);
-         xcb_intern_atom_cookie_t deleteWindowCookie = xcb_intern_atom(
-            XConnection::GetConnection(), false, std::strlen("WM_DELETE_WINDOW"), "WM_DELETE_WINDOW");
-         xcb_intern_atom_reply_t *deleteWindowAtomReply =
-            xcb_intern_atom_reply(XConnection::GetConnection(), deleteWindowCookie, nullptr);
 
          // Test if this is actually a close event.
-         if (clientEvent->data.data32[0] == deleteWindowAtomReply->atom) {
+         if (clientEvent->data.data32[0] == XConnection::GetAtom(XAtom::WM_DELETE_WINDOW)) {
             // No need to push anything. Just handle it internally!
             if (clientEvent->window == m_x11WindowID) {
                m_shouldClose = true;
             }
          }
-         free(deleteWindowAtomReply);
+         break;
+      }
+      default: {
+         X11MonitorCache &monitors = X11MonitorCache::GetInstance();
+         // The bus has already passed the notification to the monitor cache.
+         if (monitors.IsNotifyEvent(event->response_type & ~0x80)) {
+            // A single change produces a burst of notifications, but is only reported once.
+            if (monitors.GetGeneration() != m_monitorGeneration) {
+               m_monitorGeneration = monitors.GetGeneration();
+               MonitorsChangedEvent monitorsEvent;
+               monitorsEvent.sourceWindow = GetGenericID();
+               PushEvent(monitorsEvent);
+            }
+         }
          break;
       }
    }
@@ -409,14 +454,12 @@ void X11Window::EnableBorderless() noexcept {
       return; 
    }
    // Use MOTIF instead of EWMH because EWMH never seems to have quite the correct behavior.
-     xcb_intern_atom_cookie_t typeCookie =
-      xcb_intern_atom(XConnection::GetConnection(), 1, std::strlen("_MOTIF_WM_HINTS"), "_MOTIF_WM_HINTS");
-   xcb_intern_atom_reply_t *typeReply =
-      xcb_intern_atom_reply(XConnection::GetConnection(), typeCookie, nullptr);
+   xcb_atom_t hintsAtom = XConnection::GetAtom(XAtom::MOTIF_WM_HINTS);
 
     unsigned long data[5] {0};
       data[0] = 2;
-   xcb_change_property(XConnection::GetConnection(), XCB_PROP_MODE_REPLACE, m_x11WindowID, typeReply->atom, typeReply->atom, 32, 5, (unsigned char *)data);
+   xcb_change_property(XConnection::GetConnection(), XCB_PROP_MODE_REPLACE, m_x11WindowID, hintsAtom,
+                       hintsAtom, 32, 5, (unsigned char *)data);
    m_isBorderless = true;
    // Reposition will happen on the next PropertyNotify event, to reflect the correct window decoration sizes. 
 }
@@ -426,15 +469,13 @@ void X11Window::DisableBorderless() noexcept {
       return; 
    }
 
-     xcb_intern_atom_cookie_t typeCookie =
-      xcb_intern_atom(XConnection::GetConnection(), 1, std::strlen("_MOTIF_WM_HINTS"), "_MOTIF_WM_HINTS");
-   xcb_intern_atom_reply_t *typeReply =
-      xcb_intern_atom_reply(XConnection::GetConnection(), typeCookie, nullptr);
+   xcb_atom_t hintsAtom = XConnection::GetAtom(XAtom::MOTIF_WM_HINTS);
 
     unsigned long data[5] {0};
       data[0] = 2;
       data[1] = 1;
-   xcb_change_property(XConnection::GetConnection(), XCB_PROP_MODE_REPLACE, m_x11WindowID, typeReply->atom, typeReply->atom, 32, 5, (unsigned char *)data);
+   xcb_change_property(XConnection::GetConnection(), XCB_PROP_MODE_REPLACE, m_x11WindowID, hintsAtom,
+                       hintsAtom, 32, 5, (unsigned char *)data);
    m_isBorderless = false;
    // Reposition will happen on the next PropertyNotify event, to reflect the correct window decoration sizes. 
 }
@@ -443,72 +484,66 @@ void X11Window::Minimize(bool restoreVideoMode) {
    // LINUX UPDATE TODO
 }
 
-Rect X11Window::GetNewGeometry() {
-   auto geomCookie = xcb_get_geometry(XConnection::GetConnection(), m_x11WindowID);
-   auto geomReply = xcb_get_geometry_reply(XConnection::GetConnection(), geomCookie, nullptr);
+void X11Window::UpdateGeometry(const xcb_configure_notify_event_t *notifyEvent, bool synthetic) {
+   Rect geometry = m_windowGeometry;
+   geometry.width = notifyEvent->width;
+   geometry.height = notifyEvent->height;
+   if (synthetic || m_parentWindow == m_rootWindow) {
+      geometry.x = notifyEvent->x;
+      geometry.y = notifyEvent->y;
+   } else if (notifyEvent->x != m_parentOffset.x || notifyEvent->y != m_parentOffset.y) {
+      // Moved within the frame, which says nothing about where the frame itself is.
+      m_parentOffset = {notifyEvent->x, notifyEvent->y};
+      Point position = QueryRootPosition();
+      geometry.x = position.x;
+      geometry.y = position.y;
+   }
+   if (!synthetic) {
+      m_parentOffset = {notifyEvent->x, notifyEvent->y};
+   }
+   bool resized = geometry.width != m_windowGeometry.width || geometry.height != m_windowGeometry.height;
+   m_windowGeometry = geometry;
+   if (resized) {
+      WindowResizeEvent resizeEvent;
+      resizeEvent.newWidth = geometry.width;
+      resizeEvent.newHeight = geometry.height;
+      resizeEvent.sourceWindow = GetGenericID();
+      PushEvent(resizeEvent);
+   }
+}
 
-   // We have to translate to root window coordinates.
-   xcb_query_tree_cookie_t queryTreeCookie = xcb_query_tree(XConnection::GetConnection(), m_x11WindowID);
-   xcb_query_tree_reply_t *queryTree =
-      xcb_query_tree_reply(XConnection::GetConnection(), queryTreeCookie, nullptr);
+void X11Window::UpdateParent(const xcb_reparent_notify_event_t *reparentEvent) {
+   m_parentWindow = reparentEvent->parent;
+   m_parentOffset = {reparentEvent->x, reparentEvent->y};
+   if (m_parentWindow == m_rootWindow) {
+      m_windowGeometry.x = reparentEvent->x;
+      m_windowGeometry.y = reparentEvent->y;
+      return;
+   }
+   // The window manager is not obliged to send a synthetic ConfigureNotify after reparenting, so this is the
+   // only way to learn where the frame placed the window.
+   Point position = QueryRootPosition();
+   m_windowGeometry.x = position.x;
+   m_windowGeometry.y = position.y;
+}
 
-   auto translateCookie = xcb_translate_coordinates(XConnection::GetConnection(), m_x11WindowID, m_rootWindow,
-                                                    geomReply->x, geomReply->y);
-   auto translatedCoordinates =
+Point X11Window::QueryRootPosition() const {
+   auto translateCookie =
+      xcb_translate_coordinates(XConnection::GetConnection(), m_x11WindowID, m_rootWindow, 0, 0);
+   auto translateReply =
       xcb_translate_coordinates_reply(XConnection::GetConnection(), translateCookie, nullptr);
-   return {translatedCoordinates->dst_x, translatedCoordinates->dst_y, geomReply->width, geomReply->height};
+   if (!translateReply) {
+      return {m_windowGeometry.x, m_windowGeometry.y};
+   }
+   Point position {translateReply->dst_x, translateReply->dst_y};
+   free(translateReply);
+   return position;
 }
 
 std::vector<MonitorInfo> NLSWIN::Window::EnumerateMonitors() {
-   std::vector<MonitorInfo> platIndependentMonitorInfos;
-   xcb_screen_t *defaultScreen = UTIL::GetDefaultScreen();
-   if (!defaultScreen) {
-      return {};
-   }
-   XRRScreenResources *resources = XRRGetScreenResources(XConnection::GetDisplay(), UTIL::GetRootWindow());
-
-   int numMonitors = 0;
-   XRRMonitorInfo *monitorInfos =
-      XRRGetMonitors(XConnection::GetDisplay(), UTIL::GetRootWindow(), true, &numMonitors);
-   for (int i = 0; i < numMonitors; i++) {
-      // TODO: Currently only assuming one output per monitor. Could be problematic?
-      XRROutputInfo *info =
-         XRRGetOutputInfo(XConnection::GetDisplay(), resources, monitorInfos[i].outputs[0]);
-
-      std::unordered_set<XID> supportedOutputModeIDs;
-      // Get mode IDs supported by this monitor.
-      for (int j = 0; j < info->nmode; j++) { supportedOutputModeIDs.emplace(info->modes[j]); }
-
-      std::vector<VideoMode> modes;
-      // Contrast supported ID's with known modes
-      for (int j = 0; j < resources->nmode; j++) {
-         if (supportedOutputModeIDs.count(resources->modes[j].id)) {
-            XRRModeInfo modeInfo = resources->modes[j];
-            // If doublescan is set, each scanline needs to be doubled, otherwise we end up
-            // with a refreshrate thats twice as high as it should be.
-            if (modeInfo.modeFlags & RR_DoubleScan) {
-               modeInfo.vTotal = modeInfo.vTotal * 2;
-            }
-            // Calculate refresh rate.
-            float refresh = (float)modeInfo.dotClock / (modeInfo.hTotal * modeInfo.vTotal);
-            float truncatedRefresh = std::round(refresh * 100.0) / 100.0;
-
-            // Construct and store the supported video mode information.
-            VideoMode processedMode {static_cast<int>(modeInfo.width), static_cast<int>(modeInfo.height),
-                                     truncatedRefresh, static_cast<unsigned int>(modeInfo.id)};
-            modes.emplace_back(processedMode);
-         }
-      }
-
-      // We are done processing one monitor.
-      MonitorInfo monitor {monitorInfos[i].width,
-                           monitorInfos[i].height,
-                           monitorInfos[i].x,
-                           monitorInfos[i].y,
-                           info->name,
-                           modes};
-      platIndependentMonitorInfos.emplace_back(monitor);
+   std::vector<MonitorInfo> monitorInfos;
+   for (const auto &monitor: X11MonitorCache::GetInstance().GetMonitors()) {
+      monitorInfos.push_back(monitor.info);
    }
-
-   return platIndependentMonitorInfos;
-}
\ No newline at end of file
+   return monitorInfos;
+}
@@ -10,11 +10,15 @@
 #pragma once
 
 #include <GL/glx.h>
+#include <xcb/randr.h>
 #include <xcb/xcb.h>
 
 #include <unordered_map>
 #include <array>
+#include <chrono>
+#include <future>
 
+#include "../Common/VisibilityRequest.hpp"
 #include "NamelessWindow/Window.hpp"
 #include "X11EventListener.hpp"
 
@@ -35,10 +39,14 @@ class NLSWIN_API_PRIVATE X11Window : public NLSWIN::Window, public X11EventListe
    public:
    void Show() override;
    void Hide() override;
+   std::shared_future<void> ShowAsync() override;
+   std::shared_future<void> HideAsync() override;
    void SetFullscreen() override;
    void SetWindowed() noexcept override;
    void Reposition(uint32_t newX, uint32_t newY) noexcept override;
-   void Resize(uint32_t width, uint32_t height) noexcept override;
+   void Resize(uint32_t width, uint32_t height) override;
+   void SetVideoMode(const VideoMode &mode) override;
+   void RestoreVideoMode() override;
    void Focus() noexcept override;
    void EnableBorderless() noexcept override;
    void DisableBorderless() noexcept override;
@@ -55,12 +63,15 @@ class NLSWIN_API_PRIVATE X11Window : public NLSWIN::Window, public X11EventListe
    X11Window(WindowProperties properties);
    ~X11Window();
    void ToggleFullscreen() noexcept;
+   /*! Switches to the mode at a resolution, keeping the current refresh rate if the monitor supports it. */
    void SetVideoMode(uint32_t width, uint32_t height);
 
    [[nodiscard]] inline xcb_window_t GetX11ID() const noexcept { return m_x11WindowID; }
    [[nodiscard]] inline Rect GetWindowGeometry() const noexcept { return m_windowGeometry; }
    [[nodiscard]] inline xcb_window_t GetRootWindow() const noexcept { return m_rootWindow; }
    [[nodiscard]] inline xcb_visualid_t GetSelectedVisualID() const noexcept { return m_selectedVisual; }
+   /*! The GLX framebuffer configuration of the selected visual, or nullptr if none matched. */
+   [[nodiscard]] inline GLXFBConfig GetSelectedFBConfig() const noexcept { return m_selectedConfig; }
    [[nodiscard]] inline const std::array<int, 21> &GetVisualAttributes() const noexcept {
       return m_visualAttributesList;
    }
@@ -68,6 +79,14 @@ class NLSWIN_API_PRIVATE X11Window : public NLSWIN::Window, public X11EventListe
    static std::unordered_map<xcb_window_t, WindowID> m_handleMap;
    [[nodiscard]] static inline bool IsUserWindow(xcb_window_t handle) { return m_handleMap.count(handle); }
    [[nodiscard]] static inline WindowID IDFromHWND(xcb_window_t handle) { return m_handleMap.at(handle); }
+   /*!
+    * @brief Changes the core pointer events selected on every window, on behalf of the cursor.
+    *
+    * Windows select only the events they need themselves, plus this mask, so pointer input the cursor has
+    * filtered out is never sent by the X server. Windows created later select the same mask. The mask is
+    * one contribution to each window's X11EventSelections, so it never removes events selected by others.
+    */
+   static void SetPointerEventMask(xcb_event_mask_t mask);
 
    private:
    // Used only on window creation.
@@ -76,19 +95,51 @@ class NLSWIN_API_PRIVATE X11Window : public NLSWIN::Window, public X11EventListe
    void SetVisualAttributeProperty(int property, int value);
    int m_visualDepth {0};
    int m_selectedVisual {0};
+   GLXFBConfig m_selectedConfig {nullptr};
    Rect m_windowGeometry;
    void ProcessGenericEvent(xcb_generic_event_t *event) override;
-   Rect GetNewGeometry();
+   /*!
+    * @brief Updates the geometry from a ConfigureNotify, and pushes a WindowResizeEvent if the size changed.
+    *
+    * Follows the ICCCM rules for ConfigureNotify: synthetic events sent by the window manager, and real
+    * events for a window that has not been reparented, carry root coordinates. Real events for a reparented
+    * window carry coordinates relative to the window manager's frame, and the server is only queried for
+    * the root position if those change.
+    */
+   void UpdateGeometry(const xcb_configure_notify_event_t *notifyEvent, bool synthetic);
+   /*! Tracks the parent of the window, which changes when the window manager wraps it in a frame. */
+   void UpdateParent(const xcb_reparent_notify_event_t *reparentEvent);
+   /*! Asks the server where the window is, in root coordinates. Costs a round trip. */
+   [[nodiscard]] Point QueryRootPosition() const;
    WindowMode m_windowMode {WindowMode::WINDOWED};
    xcb_screen_t *m_defaultScreen {nullptr};
    xcb_window_t m_rootWindow {0};
    xcb_window_t m_x11WindowID {0};
+   /*! The root window, or the frame the window manager has reparented the window into. */
+   xcb_window_t m_parentWindow {0};
+   /*! The position of the window within its parent, as of the last real ConfigureNotify or ReparentNotify. */
+   Point m_parentOffset;
    unsigned int m_preferredBorderWidth {0};
    unsigned int m_preferredXCoord {0};
    unsigned int m_preferredYCoord {0};
    unsigned int m_preferredWidth {0};
    unsigned int m_preferredHeight {0};
    bool m_isMapped {false};
+   /*! The output whose video mode this window changed, or 0 if it has not changed any. */
+   xcb_randr_output_t m_videoModeOutput {0};
+   /*! The generation of the monitor cache that the last MonitorsChangedEvent was pushed for. */
+   uint64_t m_monitorGeneration {0};
+   /*! Completed by the next MapNotify. */
+   VisibilityRequest m_showRequest;
+   /*! Completed by the next UnmapNotify. */
+   VisibilityRequest m_hideRequest;
+   /*! How long Show and Hide wait for the window manager before giving up. */
+   static constexpr auto VISIBILITY_TIMEOUT = std::chrono::seconds(2);
+   /*!
+    * Sleeps on the connection until a visibility request completes or times out. Only this window's
+    * MapNotify and UnmapNotify are dispatched in the meantime, and every other event waits for the next poll.
+    */
+   void WaitForVisibility(const std::shared_future<void> &request);
    bool m_shouldClose {false};
    bool m_isBorderless {false};
    DecorationSizes m_decoDimensions;
@@ -114,11 +165,11 @@ class NLSWIN_API_PRIVATE X11Window : public NLSWIN::Window, public X11EventListe
                                                  GLX_ALPHA_SIZE,
                                                  8,
                                                  None};
-   const xcb_event_mask_t m_eventMask =
-      (xcb_event_mask_t)(XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_KEY_RELEASE | XCB_EVENT_MASK_FOCUS_CHANGE |
-                         XCB_EVENT_MASK_STRUCTURE_NOTIFY | XCB_EVENT_MASK_ENTER_WINDOW |
-                         XCB_EVENT_MASK_LEAVE_WINDOW | XCB_EVENT_MASK_VISIBILITY_CHANGE |
-                         XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE |
-                         XCB_EVENT_MASK_POINTER_MOTION | XCB_EVENT_MASK_PROPERTY_CHANGE);
+   /*! Selected on every window, for the window's own events and the cursor's crossing and focus handling. */
+   static constexpr uint32_t WINDOW_EVENT_MASK =
+      XCB_EVENT_MASK_STRUCTURE_NOTIFY | XCB_EVENT_MASK_FOCUS_CHANGE | XCB_EVENT_MASK_PROPERTY_CHANGE |
+      XCB_EVENT_MASK_ENTER_WINDOW | XCB_EVENT_MASK_LEAVE_WINDOW;
+   /*! The button and motion events selected on every window for the cursor. @see SetPointerEventMask */
+   static uint32_t m_pointerEventMask;
 };
 }  // namespace NLSWIN
\ No newline at end of file
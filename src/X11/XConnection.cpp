@@ -1,11 +1,14 @@
 #include "XConnection.h"
 
+#include <xcb/randr.h>
 #include <xcb/xcb.h>
 #include <xcb/xfixes.h>
+#include <xcb/xinput.h>
 #define explicit explicit_
 #include <xcb/xkb.h>
 #undef explicit
-#include <xkbcommon/xkbcommon-x11.h>
+
+#include <cstring>
 
 #include "NamelessWindow/Exceptions.hpp"
 
@@ -14,36 +17,173 @@ using namespace NLSWIN;
 xcb_connection_t* XConnection::m_xServerConnection = nullptr;
 Display* XConnection::m_Display = nullptr;
 uint8_t XConnection::m_xkbBaseEvent = 0;
+xcb_screen_t* XConnection::m_defaultScreen = nullptr;
+int XConnection::m_defaultScreenNumber = 0;
+std::array<xcb_atom_t, static_cast<size_t>(XAtom::COUNT)> XConnection::m_atoms {};
+XCapabilities XConnection::m_capabilities {};
+
+/*! The name of each XAtom, in the same order. */
+static constexpr std::array<const char*, static_cast<size_t>(XAtom::COUNT)> ATOM_NAMES {
+   "WM_PROTOCOLS",       "WM_DELETE_WINDOW", "_NET_WM_STATE", "_NET_WM_STATE_FULLSCREEN",
+   "_NET_FRAME_EXTENTS", "_MOTIF_WM_HINTS"};
 
 void XConnection::CreateConnection() {
-   if (!m_xServerConnection) {
-      m_Display = XOpenDisplay(NULL);
-      m_xServerConnection = XGetXCBConnection(m_Display);
-      XSetEventQueueOwner(m_Display, XCBOwnsEventQueue);
-      xkb_x11_setup_xkb_extension(m_xServerConnection, XCB_XKB_MAJOR_VERSION, XCB_XKB_MINOR_VERSION,
-                                  XKB_X11_SETUP_XKB_EXTENSION_NO_FLAGS, nullptr, nullptr, &m_xkbBaseEvent,
-                                  nullptr);
-      auto cookie =
-         xcb_xfixes_query_version(m_xServerConnection, XCB_XFIXES_MAJOR_VERSION, XCB_XFIXES_MINOR_VERSION);
-      auto reply = xcb_xfixes_query_version_reply(m_xServerConnection, cookie, nullptr);
-      // 4.0 or higher is needed for cursor visibility functions.
-      // TODO: Test for XRandR version 5.0 and xcb-icccm and xinput version
-      if (reply->major_version < 4) {
-         free(reply);
-         throw PlatformInitializationException();
+   if (m_xServerConnection) {
+      return;
+   }
+   // The connection is only published once every check has passed, so that a failed attempt leaves nothing
+   // half initialized behind, and the next call tries again from scratch.
+   Display* display = XOpenDisplay(NULL);
+   if (!display) {
+      throw PlatformInitializationException();
+   }
+   xcb_connection_t* connection = XGetXCBConnection(display);
+   XSetEventQueueOwner(display, XCBOwnsEventQueue);
+   int screenNumber = DefaultScreen(display);
+   auto screenIter = xcb_setup_roots_iterator(xcb_get_setup(connection));
+   for (int i = 0; i < screenNumber && screenIter.rem > 0; i++) { xcb_screen_next(&screenIter); }
+   if (screenIter.rem == 0) {
+      XCloseDisplay(display);
+      throw PlatformInitializationException();
+   }
+   QueryExtensionsAndAtoms(connection);
+   // 4.0 or higher is needed for cursor visibility functions.
+   if (m_capabilities.xfixes.major < 4) {
+      XCloseDisplay(display);
+      throw PlatformInitializationException();
+   }
+   m_defaultScreenNumber = screenNumber;
+   m_defaultScreen = screenIter.data;
+   m_Display = display;
+   m_xServerConnection = connection;
+}
+
+/*! Looks up an extension by name, for extensions whose requests this library does not otherwise use. */
+static xcb_query_extension_cookie_t QueryExtensionByName(xcb_connection_t* connection, const char* name) {
+   return xcb_query_extension(connection, std::strlen(name), name);
+}
+
+static bool IsExtensionPresent(xcb_connection_t* connection, xcb_query_extension_cookie_t cookie) {
+   xcb_query_extension_reply_t* reply = xcb_query_extension_reply(connection, cookie, nullptr);
+   bool present = reply && reply->present;
+   free(reply);
+   return present;
+}
+
+static bool IsExtensionPresent(xcb_connection_t* connection, xcb_extension_t* extension) {
+   const xcb_query_extension_reply_t* data = xcb_get_extension_data(connection, extension);
+   return data && data->present;
+}
+
+/*! Records the version from a version query reply, and frees the reply. */
+template <typename Reply>
+static XExtensionVersion TakeVersion(Reply* reply) {
+   XExtensionVersion version;
+   if (reply) {
+      version = {true, reply->major_version, reply->minor_version};
+   }
+   free(reply);
+   return version;
+}
+
+void XConnection::QueryExtensionsAndAtoms(xcb_connection_t* connection) {
+   m_capabilities = {};
+   // Every lookup and intern request goes out in the first batch. The version queries below wait on the
+   // lookups, because XCB needs each extension's major opcode to send them, and go out in the second batch.
+   xcb_prefetch_extension_data(connection, &xcb_xkb_id);
+   xcb_prefetch_extension_data(connection, &xcb_xfixes_id);
+   xcb_prefetch_extension_data(connection, &xcb_input_id);
+   xcb_prefetch_extension_data(connection, &xcb_randr_id);
+   auto presentCookie = QueryExtensionByName(connection, "Present");
+   auto mitShmCookie = QueryExtensionByName(connection, "MIT-SHM");
+   std::array<xcb_intern_atom_cookie_t, ATOM_NAMES.size()> atomCookies;
+   for (size_t i = 0; i < ATOM_NAMES.size(); i++) {
+      atomCookies[i] = xcb_intern_atom(connection, false, std::strlen(ATOM_NAMES[i]), ATOM_NAMES[i]);
+   }
+
+   bool hasXkb = IsExtensionPresent(connection, &xcb_xkb_id);
+   bool hasXfixes = IsExtensionPresent(connection, &xcb_xfixes_id);
+   bool hasXinput = IsExtensionPresent(connection, &xcb_input_id);
+   bool hasRandr = IsExtensionPresent(connection, &xcb_randr_id);
+   // Sending a request for a missing extension would fail, so only the present ones are queried.
+   xcb_xkb_use_extension_cookie_t xkbCookie {};
+   xcb_xfixes_query_version_cookie_t xfixesCookie {};
+   xcb_input_xi_query_version_cookie_t xinputCookie {};
+   xcb_randr_query_version_cookie_t randrCookie {};
+   if (hasXkb) {
+      // Equivalent to xkb_x11_setup_xkb_extension, which would wait on the reply before returning.
+      xkbCookie = xcb_xkb_use_extension(connection, XCB_XKB_MAJOR_VERSION, XCB_XKB_MINOR_VERSION);
+   }
+   if (hasXfixes) {
+      xfixesCookie = xcb_xfixes_query_version(connection, XCB_XFIXES_MAJOR_VERSION, XCB_XFIXES_MINOR_VERSION);
+   }
+   if (hasXinput) {
+      xinputCookie = xcb_input_xi_query_version(connection, XCB_INPUT_MAJOR_VERSION, XCB_INPUT_MINOR_VERSION);
+   }
+   if (hasRandr) {
+      randrCookie = xcb_randr_query_version(connection, XCB_RANDR_MAJOR_VERSION, XCB_RANDR_MINOR_VERSION);
+   }
+
+   m_capabilities.present = IsExtensionPresent(connection, presentCookie);
+   m_capabilities.mitShm = IsExtensionPresent(connection, mitShmCookie);
+   for (size_t i = 0; i < ATOM_NAMES.size(); i++) {
+      xcb_intern_atom_reply_t* reply = xcb_intern_atom_reply(connection, atomCookies[i], nullptr);
+      m_atoms[i] = reply ? reply->atom : XCB_ATOM_NONE;
+      free(reply);
+   }
+   if (hasXkb) {
+      xcb_xkb_use_extension_reply_t* reply = xcb_xkb_use_extension_reply(connection, xkbCookie, nullptr);
+      if (reply) {
+         m_capabilities.xkb = {static_cast<bool>(reply->supported), reply->serverMajor, reply->serverMinor};
       }
       free(reply);
+      m_xkbBaseEvent = xcb_get_extension_data(connection, &xcb_xkb_id)->first_event;
+   }
+   if (hasXfixes) {
+      m_capabilities.xfixes = TakeVersion(xcb_xfixes_query_version_reply(connection, xfixesCookie, nullptr));
+   }
+   if (hasXinput) {
+      m_capabilities.xinput =
+         TakeVersion(xcb_input_xi_query_version_reply(connection, xinputCookie, nullptr));
+   }
+   if (hasRandr) {
+      m_capabilities.randr = TakeVersion(xcb_randr_query_version_reply(connection, randrCookie, nullptr));
    }
 }
 
-xcb_connection_t* XConnection::GetConnection() noexcept {
+xcb_connection_t* XConnection::GetConnection() {
    if (!m_xServerConnection) {
       CreateConnection();
    }
    return m_xServerConnection;
 }
 
-Display* XConnection::GetDisplay() noexcept {
+xcb_screen_t* XConnection::GetDefaultScreen() {
+   if (!m_xServerConnection) {
+      CreateConnection();
+   }
+   return m_defaultScreen;
+}
+
+int XConnection::GetDefaultScreenNumber() {
+   if (!m_xServerConnection) {
+      CreateConnection();
+   }
+   return m_defaultScreenNumber;
+}
+
+const XCapabilities& XConnection::GetCapabilities() {
+   if (!m_xServerConnection) {
+      CreateConnection();
+   }
+   return m_capabilities;
+}
+
+xcb_window_t XConnection::GetRootWindow() {
+   return GetDefaultScreen()->root;
+}
+
+Display* XConnection::GetDisplay() {
    if (!m_Display) {
       CreateConnection();
    }
@@ -12,15 +12,79 @@
 #include <X11/Xlib-xcb.h>
 #include <xcb/xcb.h>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 #include "NamelessWindow/Exceptions.hpp"
 #include "NamelessWindow/NLSAPI.hpp"
 
 namespace NLSWIN {
-/*! @ingroup X11 */
+/*!
+ * @brief The atoms used by the X11 backend, which are interned once when the connection is created.
+ * @ingroup X11
+ */
+enum class XAtom : size_t {
+   WM_PROTOCOLS,
+   WM_DELETE_WINDOW,
+   NET_WM_STATE,
+   NET_WM_STATE_FULLSCREEN,
+   NET_FRAME_EXTENTS,
+   MOTIF_WM_HINTS,
+   COUNT
+};
+
+/*!
+ * @brief Whether the server supports an extension, and the version of it that the server agreed to use.
+ * @ingroup X11
+ */
+struct NLSWIN_API_PRIVATE XExtensionVersion {
+   bool present {false};
+   uint32_t major {0};
+   uint32_t minor {0};
+};
+
+/*!
+ * @brief The extensions available on the connection, queried once when the connection is created.
+ * @ingroup X11
+ */
+struct NLSWIN_API_PRIVATE XCapabilities {
+   XExtensionVersion xkb;
+   XExtensionVersion xfixes;
+   XExtensionVersion xinput;
+   XExtensionVersion randr;
+   bool present {false}; /*!< Only whether the server has the Present extension, not which version. */
+   bool mitShm {false};  /*!< Only whether the server has the MIT-SHM extension, not which version. */
+};
+
+/*!
+ * @ingroup X11
+ *
+ * The connection is opened by the first getter to be called, any of which throws
+ * PlatformInitializationException if it cannot be opened, or the server lacks a required extension.
+ */
 class NLSWIN_API_PRIVATE XConnection {
    public:
-   static xcb_connection_t* GetConnection() noexcept;
-   static Display* GetDisplay() noexcept;
+   static xcb_connection_t* GetConnection();
+   static Display* GetDisplay();
+   /*!
+    * The default screen, as described by the connection setup. Points into the setup data owned by the
+    * connection, so it is valid for the lifetime of the connection and costs nothing to look up.
+    */
+   static xcb_screen_t* GetDefaultScreen();
+   /*! The number of the default screen, as needed by GLX. */
+   static int GetDefaultScreenNumber();
+   /*! The root window of the default screen. */
+   static xcb_window_t GetRootWindow();
+   /*! An atom interned when the connection was created, so that looking it up never needs a round trip. */
+   inline static xcb_atom_t GetAtom(XAtom atom) {
+      if (!m_xServerConnection) {
+         CreateConnection();
+      }
+      return m_atoms[static_cast<size_t>(atom)];
+   }
+   /*! The extensions that the server supports, which never changes over the lifetime of the connection. */
+   static const XCapabilities& GetCapabilities();
    inline static uint8_t GetXKBBaseEvent() {
       if (!m_xServerConnection) {
          throw PlatformInitializationException();
@@ -32,7 +96,17 @@ class NLSWIN_API_PRIVATE XConnection {
    static xcb_connection_t* m_xServerConnection;
    static Display* m_Display;
    static uint8_t m_xkbBaseEvent;
+   static xcb_screen_t* m_defaultScreen;
+   static int m_defaultScreenNumber;
+   static std::array<xcb_atom_t, static_cast<size_t>(XAtom::COUNT)> m_atoms;
+   static XCapabilities m_capabilities;
    static void CreateConnection();
+   /*!
+    * Queries every extension, and interns every XAtom, by sending all requests before waiting on any reply.
+    * This costs two round trips, one to look the extensions up and one to negotiate their versions, no
+    * matter how many extensions and atoms there are.
+    */
+   static void QueryExtensionsAndAtoms(xcb_connection_t* connection);
    XConnection();
    XConnection(XConnection const&);
    void operator=(XConnection const&);